@@ -10,6 +10,16 @@
 #include <numeric>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <algorithm>
+#include <functional>
+
+#include "..\stuffs\LineReader.h"
+#include "..\stuffs\ChunkReduce.h"
+#include "..\stuffs\BinaryInput.h"
+#include "..\stuffs\Benchmark.h"
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
 
 #ifdef _DEBUG
 	#include <assert.h>
@@ -20,20 +30,128 @@
 
 
 
-struct Elf
+// K highest calories carried by a single elf: a min-heap of (at most) K sums, so the
+// smallest of the best is on top and every elf costs O(1), or O(log K) when it enters
+class TopCalories
 {
-	std::vector<int> food;
+public:
+	constexpr explicit TopCalories(size_t k = 3)
+		: _k(k)
+	{
+		_heap.reserve(k);
+	}
+
+	constexpr void Add(int sum)
+	{
+		if (_heap.size() < _k)
+		{
+			_heap.push_back(sum);
+			std::push_heap(_heap.begin(), _heap.end(), std::greater<int>());
+		}
+		else if (_k > 0 && sum > _heap.front())
+		{
+			std::pop_heap(_heap.begin(), _heap.end(), std::greater<int>());
+			_heap.back() = sum;
+			std::push_heap(_heap.begin(), _heap.end(), std::greater<int>());
+		}
+	}
 
-	Elf() {}
-	Elf(std::vector<int> v) : food(v) {}
-	int Sum() { return std::reduce(food.begin(), food.end()); }
+	constexpr void Merge(const TopCalories& other)
+	{
+		for (const int sum : other._heap)
+			Add(sum);
+	}
+
+	// highest first
+	constexpr std::vector<int> Sorted() const
+	{
+		std::vector<int> sorted = _heap;
+		std::sort(sorted.begin(), sorted.end(), std::greater<int>());
+		return sorted;
+	}
+
+	constexpr long long Sum() const
+	{
+		long long sum = 0;
+		for (const int calories : _heap)
+			sum += calories;
+		return sum;
+	}
+
+	constexpr size_t K() const { return _k; }
+
+private:
+	size_t            _k;
+	std::vector<int>  _heap;
 };
 
+// Sums the elves line by line: the food of an elf is added as it is read, memory is O(K)
+class CalorieCounter
+{
+public:
+	constexpr explicit CalorieCounter(size_t k)
+		: _top(k)
+	{
+	}
 
-int main()
+	constexpr void Line(std::string_view line)
+	{
+		if (line.empty())
+		{
+			if (_elf)
+				_top.Add(_sum);
+			_sum = 0;
+			_elf = false;
+			return;
+		}
+
+		_sum += ParseInt(line);
+		_elf = true;
+	}
+
+	constexpr TopCalories Top() const
+	{
+		TopCalories top = _top;
+		if (_elf)
+			top.Add(_sum);
+		return top;
+	}
+
+private:
+	TopCalories _top;
+	int         _sum = 0;
+	bool        _elf = false;  // some food in the current group
+};
+
+TopCalories CountCalories(std::istream& in, size_t k = 3)
 {
-#if 0
-	std::istringstream in(
+	TRACE_SCOPE("both parts", "day01");
+
+	CalorieCounter counter(k);
+	ForEachLine(in, [&](std::string_view line) { counter.Line(line); });
+	return counter.Top();
+}
+
+constexpr TopCalories CountCalories(std::string_view data, size_t k = 3)
+{
+	CalorieCounter counter(k);
+	ForEachLine(data, [&](std::string_view line) { counter.Line(line); });
+	return counter.Top();
+}
+
+// Chunks of whole elves (cut at blank lines) counted in parallel
+TopCalories CountCalories(std::string_view data, size_t k, size_t num_threads)
+{
+	ThreadPool pool(num_threads);
+
+	const auto chunks = SplitChunks(data, 4 * pool.Size(), NextGroup);
+	return ReduceChunks(pool, chunks, TopCalories(k),
+		[k](std::string_view chunk) { return CountCalories(chunk, k); },
+		[](TopCalories top, const TopCalories& other) { top.Merge(other); return top; });
+}
+
+// sample of the puzzle, solved at compile time
+constexpr std::string_view SAMPLE =
 R"(1000
 2000
 3000
@@ -47,52 +165,48 @@ R"(1000
 8000
 9000
 
-10000)");
+10000)";
+
+static_assert(CountCalories(SAMPLE, 1).Sum() == 24000);
+static_assert(CountCalories(SAMPLE, 3).Sum() == 45000);
+static_assert(CountCalories(SAMPLE, 10).Sum() == 55000);  // fewer elves than K
+
+int main()
+{
+#if 0
+	std::istringstream in{std::string(SAMPLE)};
 #else
 	std::ifstream in("input1.txt");
 #endif
 
+#if 0
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) {
+		return CountCalories(in).Sum();
+	});
+#elif 0
+	// streaming a (possibly huge) input from stdin: throughput and peak memory (O(K), whatever the elves)
+	const size_t K = 3;
+	MeasureStream(std::cin, [K](std::istream& in) {
+		return CountCalories(in, K).Sum();
+	});
+#elif 0
+	// chunks of the mapped input in parallel, from 1 to N cores
+	MappedFile file;
+	if (!file.Open("input1.txt"))
+		return 1;
+	const std::string_view data(file.Data(), file.Size());
+	MeasureScaling(in, [&](std::istream&, size_t num_threads) {
+		return CountCalories(data, 3, num_threads).Sum();
+	});
+#else
+	const TopCalories top = CountCalories(in, 3);
 
-	std::vector<Elf> elves;
-
-	while (in)
-	{
-		Elf elf;
-
-		for (std::string line; std::getline(in, line);)
-		{
-			if (line.empty())
-				break;
-			elf.food.push_back(std::stoi(line));
-		}
-
-		elves.push_back(elf);
-	}
-
-	int max[] = {0, 0, 0};
-	for(auto elf : elves)
-	{
-		int sum = elf.Sum();
-		if (sum > max[0])
-		{
-			max[2] = max[1];
-			max[1] = max[0];
-			max[0] = sum;
-		}
-		else if (sum > max[1])
-		{
-			max[2] = max[1];
-			max[1] = sum;
-		}
-		else if (sum > max[2])
-		{
-			max[2] = sum;
-		}
-	}
-
-	std::cout << max[0] << std::endl;  // 67450
-	std::cout << max[1] << std::endl;
-	std::cout << max[2] << std::endl;
+	for (const int calories : top.Sorted())
+		std::cout << calories << std::endl;  // 67450, ...
 	std::cout << std::endl;
-	std::cout << max[0]+max[1]+max[2] << std::endl;  // 199357
+	std::cout << top.Sum() << std::endl;  // 199357
+#endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
\ No newline at end of file
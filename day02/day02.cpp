@@ -12,8 +12,15 @@
 #include <string>
 #include <ranges>
 #include <string_view>
+#include <array>
+#include <cstdint>
 
-#include "..\stuffs\Splitter.h"
+#include "..\stuffs\LineReader.h"
+#include "..\stuffs\ChunkReduce.h"
+#include "..\stuffs\BinaryInput.h"
+#include "..\stuffs\Benchmark.h"
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
 
 #ifdef _DEBUG
 	#include <assert.h>
@@ -24,11 +31,11 @@
 
 
 
-const int R = 0;
-const int P = 1;
-const int S = 2;
+constexpr int R = 0;
+constexpr int P = 1;
+constexpr int S = 2;
 
-const int SCORES[3][3] =  // [im][io]  im == index "me", io = index "opponent"
+constexpr int SCORES[3][3] =  // [im][io]  im == index "me", io = index "opponent"
 {
 	//    R  P  S
 		{ 3, 0, 6 },  // R
@@ -36,7 +43,7 @@ const int SCORES[3][3] =  // [im][io]  im == index "me", io = index "opponent"
 		{ 0, 6, 3 },  // S
 };
 
-const int MOVES[3][3] =  // [imr][io]  imr == index "my result", io = index "opponent"
+constexpr int MOVES[3][3] =  // [imr][io]  imr == index "my result", io = index "opponent"
 {
 	//    R  P  S
 		{ S, R, P },  // L
@@ -44,73 +51,236 @@ const int MOVES[3][3] =  // [imr][io]  imr == index "my result", io = index "opp
 		{ P, S, R },  // W
 };
 
-int PartOne(std::istream& in)
+constexpr int ScoreOne(std::string_view line)
 {
-	int score = 0;
-	for (std::string line; std::getline(in, line);)
-	{
-		if (line.empty())
-			break;
+	if (line.empty())
+		return 0;
 
-		auto sline = split(line, " ");
-		ASSERT(sline.size() == 2);
+	ASSERT(line.size() == 3 && line[1] == ' ');
+	int om = line[0] - 'A';
+	ASSERT(0 <= om && om <= 2);
 
-		ASSERT(sline[0].size() == 1);
-		int om = sline[0][0] - 'A';
-		ASSERT( 0 <= om && om <= 2);
+	int im = line[2] - 'X';
+	ASSERT(0 <= im && im <= 2);
 
-		ASSERT(sline[1].size() == 1);
-		int im = sline[1][0] - 'X';
-		ASSERT(0 <= im && im <= 2);
+	return SCORES[im][om] + (im+1);
+}
 
-		score += SCORES[im][om] + (im+1);
-	}
+constexpr int ScoreTwo(std::string_view line)
+{
+	if (line.empty())
+		return 0;
+
+	ASSERT(line.size() == 3 && line[1] == ' ');
+	int om = line[0] - 'A';
+	ASSERT(0 <= om && om <= 2);
+
+	int imr = line[2] - 'X';
+	ASSERT(0 <= imr && imr <= 2);
+	int im = MOVES[imr][om];
+
+	return SCORES[im][om] + (im+1);
+}
+
+// Single pass, constant memory
+long long PartOne(std::istream& in)
+{
+	TRACE_SCOPE("part one", "day02");
+
+	long long score = 0;
+	ForEachLine(in, [&](std::string_view line) { score += ScoreOne(line); });
+	return score;
+}
+
+long long PartTwo(std::istream& in)
+{
+	TRACE_SCOPE("part two", "day02");
 
+	long long score = 0;
+	ForEachLine(in, [&](std::string_view line) { score += ScoreTwo(line); });
 	return score;
 }
 
-int PartTwo(std::istream& in)
+// Whole input in memory
+constexpr long long PartOne(std::string_view data)
+{
+	long long score = 0;
+	ForEachLine(data, [&](std::string_view line) { score += ScoreOne(line); });
+	return score;
+}
+
+constexpr long long PartTwo(std::string_view data)
+{
+	long long score = 0;
+	ForEachLine(data, [&](std::string_view line) { score += ScoreTwo(line); });
+	return score;
+}
+
+// Chunks of the input in parallel
+long long PartOne(std::string_view data, size_t num_threads)
+{
+	ThreadPool pool(num_threads);
+	return SumLines<long long>(pool, data, ScoreOne);
+}
+
+long long PartTwo(std::string_view data, size_t num_threads)
+{
+	ThreadPool pool(num_threads);
+	return SumLines<long long>(pool, data, ScoreTwo);
+}
+
+// Both parts in a single pass over the raw bytes: records are "X Y\n", the two letters
+// make a 4-bit index (their two low bits) into a table of both scores, packed in 64 bits
+struct Scores
 {
-	int score = 0;
-	for (std::string line; std::getline(in, line);)
+	long long one = 0;
+	long long two = 0;
+
+	constexpr Scores& operator += (const Scores& other) { one += other.one; two += other.two; return *this; }
+};
+
+constexpr size_t RecordIndex(char opponent, char me) { return ((opponent & 3) << 2) | (me & 3); }
+
+constexpr std::array<uint64_t, 16> MakeScoreTable()
+{
+	std::array<uint64_t, 16> table{};
+	for (char opponent = 'A'; opponent <= 'C'; ++opponent)
 	{
-		if (line.empty())
-			break;
+		for (char me = 'X'; me <= 'Z'; ++me)
+		{
+			const char record[] = { opponent, ' ', me };
+			const std::string_view line(record, 3);
+			table[RecordIndex(opponent, me)] = (uint64_t)ScoreOne(line) | ((uint64_t)ScoreTwo(line) << 32);
+		}
+	}
+	return table;
+}
 
-		auto sline = split(line, " ");
-		ASSERT(sline.size() == 2);
+constexpr std::array<uint64_t, 16> SCORE_TABLE = MakeScoreTable();
 
-		ASSERT(sline[0].size() == 1);
-		int om = sline[0][0] - 'A';
-		ASSERT(0 <= om && om <= 2);
+constexpr Scores ScoreBoth(std::string_view data)
+{
+	constexpr size_t BLOCK = 16;          // records per iteration
+	constexpr size_t FLUSH = 1 << 24;     // records before the packed 32-bit halves could overflow
 
-		ASSERT(sline[1].size() == 1);
-		int imr = sline[1][0] - 'X';
-		ASSERT(0 <= imr && imr <= 2);
-		int im = MOVES[imr][om];
+	Scores scores;
+	uint64_t packed = 0;
+	size_t packed_records = 0;
+	auto flush = [&]() {
+		scores.one += packed & 0xffffffff;
+		scores.two += packed >> 32;
+		packed = 0;
+		packed_records = 0;
+	};
+
+	for (size_t pos = 0; pos < data.size(); )
+	{
+		// fast path: a block of well formed records, no branches inside
+		if (pos + 4*BLOCK <= data.size())
+		{
+			bool well_formed = true;
+			for (size_t i = 0; i < BLOCK; ++i)
+				well_formed &= (data[pos + 4*i + 1] == ' ') & (data[pos + 4*i + 3] == '\n');
+
+			if (well_formed)
+			{
+				for (size_t i = 0; i < BLOCK; ++i)
+					packed += SCORE_TABLE[RecordIndex(data[pos + 4*i], data[pos + 4*i + 2])];
+				pos += 4*BLOCK;
+
+				if ((packed_records += BLOCK) >= FLUSH)
+					flush();
+				continue;
+			}
+		}
+
+		// slow path: a single line ("\r\n", blank or last line)
+		size_t end = data.find('\n', pos);
+		if (end == std::string_view::npos)
+			end = data.size();
+		std::string_view line = data.substr(pos, end - pos);
+		if (!line.empty() && line.back() == '\r')
+			line.remove_suffix(1);
+
+		scores.one += ScoreOne(line);
+		scores.two += ScoreTwo(line);
+		pos = end + 1;
+	}
 
-		score += SCORES[im][om] + (im + 1);
+	flush();
+	return scores;
 }
 
-	return score;
+// Chunks of the input in parallel, both parts at once
+Scores ScoreBoth(std::string_view data, size_t num_threads)
+{
+	ThreadPool pool(num_threads);
+
+	const auto chunks = SplitChunks(data, 4 * pool.Size(), NextLine);
+	return ReduceChunks(pool, chunks, Scores(),
+		[](std::string_view chunk) { return ScoreBoth(chunk); },
+		[](Scores l, const Scores& r) { return l += r; });
+}
+
+// sample of the puzzle, solved at compile time
+constexpr std::string_view SAMPLE =
+R"(A Y
+B X
+C Z)";
+
+static_assert(PartOne(SAMPLE) == 15);
+static_assert(PartTwo(SAMPLE) == 12);
+static_assert(ScoreBoth(SAMPLE).one == 15 && ScoreBoth(SAMPLE).two == 12);
+
+// long enough to take the fast path of ScoreBoth
+constexpr Scores ScoreRepeated(std::string_view records, size_t times)
+{
+	std::string data;
+	for (size_t i = 0; i < times; ++i)
+		data += records;
+	return ScoreBoth(data);
 }
 
+static_assert(ScoreRepeated("A Y\nB X\nC Z\n", 100).one == 1500 && ScoreRepeated("A Y\nB X\nC Z\n", 100).two == 1200);
+static_assert(ScoreRepeated("A Y\r\nB X\r\nC Z\r\n", 100).one == 1500);
+
 int main()
 {
 #if 0
-	std::istringstream in(
-R"(A Y
-B X
-C Z)");
+	std::istringstream in{std::string(SAMPLE)};
 #else
 	std::ifstream in("input1.txt");
 #endif
 
 #if 0
-	int score = PartOne(in);
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) { return PartTwo(in); });
+#elif 0
+	// streaming a (possibly huge) input from stdin: throughput and peak memory
+	MeasureStream(std::cin, [](std::istream& in) { return PartTwo(in); });
+#elif 0
+	// chunks of the mapped input in parallel, from 1 to N cores
+	MappedFile file;
+	if (!file.Open("input1.txt"))
+		return 1;
+	const std::string_view data(file.Data(), file.Size());
+	MeasureScaling(in, [&](std::istream&, size_t num_threads) { return PartTwo(data, num_threads); });
+#elif 0
+	// lookup table kernel, both parts in one pass, vs a pass per part
+	MappedFile file;
+	if (!file.Open("input1.txt"))
+		return 1;
+	const std::string_view data(file.Data(), file.Size());
+	MeasureTime("line by line, two passes", [&]() { return std::to_string(PartOne(data)) + " " + std::to_string(PartTwo(data)); });
+	MeasureTime("table, one pass", [&]() { const Scores scores = ScoreBoth(data); return std::to_string(scores.one) + " " + std::to_string(scores.two); });
+	MeasureScaling(in, [&](std::istream&, size_t num_threads) { return ScoreBoth(data, num_threads).two; });
+#elif 0
+	long long score = PartOne(in);
 	std::cout << score << std::endl;  // 11666
 #else
-	int score = PartTwo(in);
+	long long score = PartTwo(in);
 	std::cout << score << std::endl;  // 12767
 #endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
\ No newline at end of file
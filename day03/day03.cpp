@@ -12,8 +12,21 @@
 //#include <string>
 //#include <ranges>
 //#include <string_view>
-#include <set>
 #include <algorithm>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <vector>
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#include "..\stuffs\LineReader.h"
+#include "..\stuffs\ChunkReduce.h"
+#include "..\stuffs\BinaryInput.h"
+#include "..\stuffs\Benchmark.h"
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
 
 #ifdef _DEBUG
 	#include <assert.h>
@@ -24,7 +37,7 @@
 
 
 
-int Score(std::string::value_type ch)
+constexpr int Score(std::string::value_type ch)
 {
 	if ('a' <= ch && ch <= 'z')
 		return ch - 'a' + 1;
@@ -33,83 +46,231 @@ int Score(std::string::value_type ch)
 	return ch - 'A' + 27;
 }
 
-int PartOne(std::istream& in)
+// Sets of items are 64-bit masks, bit == priority (1..52): intersections are a single AND,
+// and the priority of the common item is the index of the lowest bit set
+typedef uint64_t items_t;
+
+constexpr std::array<unsigned char, 256> MakePriorities()
 {
-	int score = 0;
+	std::array<unsigned char, 256> priorities{};  // 0 (not an item) for anything else
+	for (char ch = 'a'; ch <= 'z'; ++ch)
+		priorities[(unsigned char)ch] = (unsigned char)Score(ch);
+	for (char ch = 'A'; ch <= 'Z'; ++ch)
+		priorities[(unsigned char)ch] = (unsigned char)Score(ch);
+	return priorities;
+}
 
-	for (std::string line; std::getline(in, line);)
-	{
-		std::set s0(line.begin(), line.begin() + line.size() / 2);
-		std::set s1(              line.begin() + line.size() / 2, line.end());
+constexpr std::array<unsigned char, 256> PRIORITIES = MakePriorities();
 
-		std::string inters;
-		std::set_intersection(s0.begin(), s0.end(),
-		                      s1.begin(), s1.end(),
-		                      std::back_inserter(inters));
+constexpr items_t ITEMS_ALL = ~(items_t)1;  // bit 0 is not an item
 
-		ASSERT(inters.size() == 1);
-		score += Score(inters[0]);
+constexpr items_t Items(std::string_view str)
+{
+	// blocks of 32 bytes, no dependencies between the lanes: the compiler can vectorize them
+	constexpr size_t BLOCK = 32;
+
+	items_t items = 0;
+	size_t i = 0;
+	for (; i + BLOCK <= str.size(); i += BLOCK)
+	{
+		items_t block = 0;
+		for (size_t j = 0; j < BLOCK; ++j)
+			block |= (items_t)1 << PRIORITIES[(unsigned char)str[i + j]];
+		items |= block;
 	}
+	for (; i < str.size(); ++i)
+		items |= (items_t)1 << PRIORITIES[(unsigned char)str[i]];
 
-	return score;
+	return items & ITEMS_ALL;
+}
+
+constexpr int Priority(items_t items)
+{
+	ASSERT(std::has_single_bit(items));
+	return std::countr_zero(items);
 }
 
-int PartTwo(std::istream& in)
+// Priority of the item in both the compartments
+constexpr int ScoreRucksack(std::string_view line)
 {
-	int score = 0;
+	if (line.empty())
+		return 0;
 
-	for (std::string line; in;)
+	const size_t half = line.size() / 2;
+	return Priority(Items(line.substr(0, half)) & Items(line.substr(half)));
+}
+
+// Priorities of the badges, line by line: only the items of the current group are kept
+class BadgeScorer
+{
+public:
+	constexpr void Line(std::string_view line)
 	{
-		if (!std::getline(in, line))
-			break;
-		std::set s0(line.begin(), line.end());
-
-		if (!std::getline(in, line))
-			break;
-		std::set s1(line.begin(), line.end());
-
-		if (!std::getline(in, line))
-			break;
-		std::set s2(line.begin(), line.end());
-
-		std::string inters;
-		std::set_intersection(s0.begin(), s0.end(),
-			                  s1.begin(), s1.end(),
-			                  std::back_inserter(inters));
-		s0.clear();
-		s0.insert(inters.begin(), inters.end());
-		inters.clear();
-
-		std::set_intersection(s0.begin(), s0.end(),
-			                  s2.begin(), s2.end(),
-			                  std::back_inserter(inters));
-
-		ASSERT(inters.size() == 1);
-		score += Score(inters[0]);
+		if (line.empty())
+			return;
+
+		_group &= Items(line);
+
+		if (++_index < 3)
+			return;
+		_index = 0;
+
+		_score += Priority(_group);
+		_group = ITEMS_ALL;
 	}
 
+	constexpr long long Result() const { return _score; }
+
+private:
+	items_t    _group = ITEMS_ALL;  // items in all the lines of the group, so far
+	int        _index = 0;          // of the line in the group
+	long long  _score = 0;
+};
+
+// Single pass, constant memory
+long long PartOne(std::istream& in)
+{
+	TRACE_SCOPE("part one", "day03");
+
+	long long score = 0;
+	ForEachLine(in, [&](std::string_view line) { score += ScoreRucksack(line); });
 	return score;
 }
 
-int main()
+long long PartTwo(std::istream& in)
 {
-#if 0
-	std::istringstream in(
+	TRACE_SCOPE("part two", "day03");
+
+	BadgeScorer scorer;
+	ForEachLine(in, [&](std::string_view line) { scorer.Line(line); });
+	return scorer.Result();
+}
+
+// Whole input in memory
+constexpr long long PartOne(std::string_view data)
+{
+	long long score = 0;
+	ForEachLine(data, [&](std::string_view line) { score += ScoreRucksack(line); });
+	return score;
+}
+
+constexpr long long PartTwo(std::string_view data)
+{
+	BadgeScorer scorer;
+	ForEachLine(data, [&](std::string_view line) { scorer.Line(line); });
+	return scorer.Result();
+}
+
+// Chunks of the input in parallel
+long long PartOne(std::string_view data, size_t num_threads)
+{
+	ThreadPool pool(num_threads);
+	return SumLines<long long>(pool, data, ScoreRucksack);
+}
+
+// Chunks of whole groups of three lines in parallel
+long long PartTwo(std::string_view data, size_t num_threads)
+{
+	ThreadPool pool(num_threads);
+
+	const auto chunks = SplitLineRecords(pool, data, 4 * pool.Size(), 3);
+	return ReduceChunks(pool, chunks, 0LL,
+		[](std::string_view chunk) {
+			return PartTwo(chunk);
+		},
+		std::plus<long long>());
+}
+
+// sample of the puzzle, solved at compile time
+constexpr std::string_view SAMPLE =
 R"(vJrwpWtwJgWrhcsFMMfFFhFp
 jqHRNqRjqzjGDLGLrsFMfFZSrLrFZsSL
 PmmdzqPrVvPwwTWBwg
 wMqvLMZHhHMvwLHjbvcjnnSBnvTQFn
 ttgJtRGJQctTZtZT
-CrZsJsPPZsGzwwsLwLmpwMDw)");
+CrZsJsPPZsGzwwsLwLmpwMDw)";
+
+static_assert(PartOne(SAMPLE) == 157);
+static_assert(PartTwo(SAMPLE) == 70);
+
+// Synthetic input of (about) 'bytes' bytes, for throughput: groups of three well formed
+// rucksacks, every line only shares its badge with the other two lines of the group
+std::string MakeSynthetic(size_t bytes, uint64_t seed = 1)
+{
+	SyntheticRng rng(seed);
+	auto item = [](int priority) { return (char)(priority <= 26 ? 'a' + priority - 1 : 'A' + priority - 27); };
+
+	std::string data;
+	data.reserve(bytes + 128);
+	while (data.size() < bytes)
+	{
+		const int badge = 1 + (int)rng.Below(52);
+		for (int k = 0; k < 3; ++k)
+		{
+			// the items of the k-th line (but the badge) are the ones with priority % 3 == k
+			std::vector<int> pool;
+			for (int priority = 1; priority <= 52; ++priority)
+				if (priority % 3 == k && priority != badge)
+					pool.push_back(priority);
+
+			const size_t iShared = rng.Below(pool.size());
+			const int shared = pool[iShared];
+			pool.erase(pool.begin() + iShared);
+
+			const size_t half = 8 + rng.Below(17);
+			std::string first, second;
+			first += item(shared);
+			second += item(shared);
+			if (shared != badge)
+				first += item(badge);
+			while (first.size() < half)
+				first += item(pool[2 * rng.Below(pool.size() / 2)]);      // even positions of the pool
+			while (second.size() < first.size())
+				second += item(pool[2 * rng.Below(pool.size() / 2) + 1]); // odd positions of the pool
+
+			data += first;
+			data += second;
+			data += '\n';
+		}
+	}
+	return data;
+}
+
+int main()
+{
+#if 0
+	std::istringstream in{std::string(SAMPLE)};
 #else
 	std::ifstream in("input1.txt");
 #endif
 
 #if 0
-	int score = PartOne(in);
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) { return PartTwo(in); });
+#elif 0
+	// streaming a (possibly huge) input from stdin: throughput and peak memory
+	MeasureStream(std::cin, [](std::istream& in) { return PartTwo(in); });
+#elif 0
+	// chunks of the mapped input in parallel, from 1 to N cores
+	MappedFile file;
+	if (!file.Open("input1.txt"))
+		return 1;
+	const std::string_view data(file.Data(), file.Size());
+	MeasureScaling(in, [&](std::istream&, size_t num_threads) { return PartTwo(data, num_threads); });
+#elif 0
+	// throughput of the item masks on a synthetic multi-GB input
+	const std::string data = MakeSynthetic((size_t)4 << 30);
+	std::cout << data.size() / double(1 << 30) << " GiB" << std::endl;
+	MeasureTime("part one", [&]() { return PartOne(std::string_view(data)); }, 3);
+	MeasureTime("part two", [&]() { return PartTwo(std::string_view(data)); }, 3);
+	MeasureScaling(in, [&](std::istream&, size_t num_threads) { return PartTwo(std::string_view(data), num_threads); });
+#elif 0
+	long long score = PartOne(in);
 	std::cout << score << std::endl;  // 8139
 #else
-	int score = PartTwo(in);
+	long long score = PartTwo(in);
 	std::cout << score << std::endl;  // 2668
 #endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
\ No newline at end of file
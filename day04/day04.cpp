@@ -12,8 +12,15 @@
 #include <string>
 #include <ranges>
 #include <string_view>
+#include <algorithm>
+#include <cstdint>
 
-#include "..\stuffs\Splitter.h"
+#include "..\stuffs\LineReader.h"
+#include "..\stuffs\ChunkReduce.h"
+#include "..\stuffs\BinaryInput.h"
+#include "..\stuffs\Benchmark.h"
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
 
 #ifdef _DEBUG
 	#include <assert.h>
@@ -29,108 +36,243 @@ struct Elf
 	int from;
 	int to;
 
-	Elf()
+	constexpr Elf()
 		: Elf(0, 0)
 	{
 	}
 
-	Elf(int _from, int _to)
+	constexpr Elf(int _from, int _to)
 		: from(_from), to(_to)
 	{
 		ASSERT(from <= to);
 	}
 
-	bool Includes(const Elf& e) const { return from <= e.from && e.to <= to; }
-	bool Overlaps(const Elf& e) const { return from <= e.to && e.from <= to; }
+	constexpr bool Includes(const Elf& e) const { return from <= e.from && e.to <= to; }
+	constexpr bool Overlaps(const Elf& e) const { return from <= e.to && e.from <= to; }
 };
 
 
-int PartOne(std::istream& in)
+// "a-b,c-d"
+constexpr void ParsePair(std::string_view line, Elf elf[2])
 {
-	int count = 0;
-	for (std::string line; std::getline(in, line);)
-	{
-		if (line.empty())
-			break;
+	const int from0 = ParseInt(line);
+	const int to0   = ParseInt(line);
+	const int from1 = ParseInt(line);
+	const int to1   = ParseInt(line);
+	ASSERT(line.empty());
 
-		auto sline = split(line, ",");
-		ASSERT(sline.size() == 2);
+	elf[0] = Elf(from0, to0);
+	elf[1] = Elf(from1, to1);
+}
 
-		Elf elf[2];
-		{
-			auto elve_parts = split(sline[0], "-");
-			ASSERT(elve_parts.size() == 2);
-			elf[0] = Elf(std::stoi(elve_parts[0]),
-			               std::stoi(elve_parts[1]));
-		}
-		{
-			auto elve_parts = split(sline[1], "-");
-			ASSERT(elve_parts.size() == 2);
-			elf[1] = Elf(std::stoi(elve_parts[0]),
-			               std::stoi(elve_parts[1]));
-		}
+// 1 if an elf of the pair includes the other, 0 otherwise
+constexpr int CountIncluded(std::string_view line)
+{
+	if (line.empty())
+		return 0;
 
-		if (elf[0].Includes(elf[1]) || elf[1].Includes(elf[0]))
-			++count;
-	}
+	Elf elf[2];
+	ParsePair(line, elf);
+
+	return (elf[0].Includes(elf[1]) || elf[1].Includes(elf[0])) ? 1 : 0;
+}
+
+// 1 if the elves of the pair overlap, 0 otherwise
+constexpr int CountOverlapping(std::string_view line)
+{
+	if (line.empty())
+		return 0;
+
+	Elf elf[2];
+	ParsePair(line, elf);
+
+	ASSERT(elf[0].Overlaps(elf[1]) == elf[1].Overlaps(elf[0]));
+	return elf[0].Overlaps(elf[1]) ? 1 : 0;
+}
+
+// Single pass, constant memory
+long long PartOne(std::istream& in)
+{
+	TRACE_SCOPE("part one", "day04");
 
+	long long count = 0;
+	ForEachLine(in, [&](std::string_view line) { count += CountIncluded(line); });
 	return count;
 }
 
-int PartTwo(std::istream& in)
+long long PartTwo(std::istream& in)
+{
+	TRACE_SCOPE("part two", "day04");
+
+	long long count = 0;
+	ForEachLine(in, [&](std::string_view line) { count += CountOverlapping(line); });
+	return count;
+}
+
+// Whole input in memory
+constexpr long long PartOne(std::string_view data)
+{
+	long long count = 0;
+	ForEachLine(data, [&](std::string_view line) { count += CountIncluded(line); });
+	return count;
+}
+
+constexpr long long PartTwo(std::string_view data)
+{
+	long long count = 0;
+	ForEachLine(data, [&](std::string_view line) { count += CountOverlapping(line); });
+	return count;
+}
+
+// Chunks of the input in parallel
+long long PartOne(std::string_view data, size_t num_threads)
+{
+	ThreadPool pool(num_threads);
+	return SumLines<long long>(pool, data, CountIncluded);
+}
+
+long long PartTwo(std::string_view data, size_t num_threads)
+{
+	ThreadPool pool(num_threads);
+	return SumLines<long long>(pool, data, CountOverlapping);
+}
+
+// Columnar store of the pairs: one int32 array per bound, so that both the counts are
+// a single pass of branch-free compares over contiguous arrays (that vectorizes)
+struct Assignments
 {
-	int count = 0;
-	for (std::string line; std::getline(in, line);)
+	std::vector<int32_t> a_from, a_to;
+	std::vector<int32_t> b_from, b_to;
+
+	constexpr size_t Size() const { return a_from.size(); }
+
+	constexpr void Reserve(size_t size)
 	{
-		if (line.empty())
-			break;
+		a_from.reserve(size);
+		a_to.reserve(size);
+		b_from.reserve(size);
+		b_to.reserve(size);
+	}
 
-		auto sline = split(line, ",");
-		ASSERT(sline.size() == 2);
+	constexpr void Line(std::string_view line)
+	{
+		if (line.empty())
+			return;
 
 		Elf elf[2];
-		{
-			auto elve_parts = split(sline[0], "-");
-			ASSERT(elve_parts.size() == 2);
-			elf[0] = Elf(std::stoi(elve_parts[0]),
-			               std::stoi(elve_parts[1]));
+		ParsePair(line, elf);
+
+		a_from.push_back(elf[0].from);
+		a_to.push_back(elf[0].to);
+		b_from.push_back(elf[1].from);
+		b_to.push_back(elf[1].to);
 	}
-		{
-			auto elve_parts = split(sline[1], "-");
-			ASSERT(elve_parts.size() == 2);
-			elf[1] = Elf(std::stoi(elve_parts[0]),
-			               std::stoi(elve_parts[1]));
-		}
+};
+
+constexpr Assignments LoadAssignments(std::string_view data)
+{
+	Assignments pairs;
+	pairs.Reserve(std::count(data.begin(), data.end(), '\n') + 1);
+	ForEachLine(data, [&](std::string_view line) { pairs.Line(line); });
+	return pairs;
+}
+
+struct Counts
+{
+	long long included = 0;     // part one
+	long long overlapping = 0;  // part two
+};
+
+constexpr Counts CountBoth(const Assignments& pairs)
+{
+	// 32-bit lanes while the block counts cannot overflow, then 64-bit totals
+	constexpr size_t BLOCK = 1 << 20;
 
-		if (elf[0].Overlaps(elf[1]))
+	Counts counts;
+	for (size_t begin = 0; begin < pairs.Size(); begin += BLOCK)
+	{
+		const size_t end = std::min(begin + BLOCK, pairs.Size());
+
+		int32_t included = 0, overlapping = 0;
+		for (size_t i = begin; i < end; ++i)
 		{
-			ASSERT(elf[1].Overlaps(elf[0]));
-			++count;
+			const int32_t af = pairs.a_from[i], at = pairs.a_to[i];
+			const int32_t bf = pairs.b_from[i], bt = pairs.b_to[i];
+
+			included    += ((af <= bf) & (bt <= at)) | ((bf <= af) & (at <= bt));
+			overlapping += (af <= bt) & (bf <= at);
 		}
-}
 
-	return count;
+		counts.included += included;
+		counts.overlapping += overlapping;
+	}
+	return counts;
 }
 
-int main()
+// Synthetic input of 'pairs' lines, for throughput
+std::string MakeSynthetic(size_t pairs, uint64_t seed = 1)
 {
-#if 0
-	std::istringstream in(
+	SyntheticRng rng(seed);
+
+	std::string data;
+	data.reserve(pairs * 12);
+	for (size_t i = 0; i < pairs; ++i)
+	{
+		const int af = 1 + (int)rng.Below(99), at = af + (int)rng.Below(100 - af);
+		const int bf = 1 + (int)rng.Below(99), bt = bf + (int)rng.Below(100 - bf);
+		data += std::to_string(af) + '-' + std::to_string(at) + ',' + std::to_string(bf) + '-' + std::to_string(bt) + '\n';
+	}
+	return data;
+}
+
+// sample of the puzzle, solved at compile time
+constexpr std::string_view SAMPLE =
 R"(2-4,6-8
 2-3,4-5
 5-7,7-9
 2-8,3-7
 6-6,4-6
-2-6,4-8)");
+2-6,4-8)";
+
+static_assert(PartOne(SAMPLE) == 2);
+static_assert(PartTwo(SAMPLE) == 4);
+static_assert(CountBoth(LoadAssignments(SAMPLE)).included == 2 && CountBoth(LoadAssignments(SAMPLE)).overlapping == 4);
+
+int main()
+{
+#if 0
+	std::istringstream in{std::string(SAMPLE)};
 #else
 	std::ifstream in("input1.txt");
 #endif
 
 #if 0
-	int score = PartOne(in);
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) { return PartTwo(in); });
+#elif 0
+	// streaming a (possibly huge) input from stdin: throughput and peak memory
+	MeasureStream(std::cin, [](std::istream& in) { return PartTwo(in); });
+#elif 0
+	// chunks of the mapped input in parallel, from 1 to N cores
+	MappedFile file;
+	if (!file.Open("input1.txt"))
+		return 1;
+	const std::string_view data(file.Data(), file.Size());
+	MeasureScaling(in, [&](std::istream&, size_t num_threads) { return PartTwo(data, num_threads); });
+#elif 0
+	// columnar store vs line by line, on 10^8 synthetic pairs
+	const std::string data = MakeSynthetic(100'000'000);
+	MeasureTime("line by line, both parts", [&]() { return std::to_string(PartOne(std::string_view(data))) + " " + std::to_string(PartTwo(std::string_view(data))); }, 3);
+	MeasureTime("columnar load", [&]() { return LoadAssignments(data).Size(); }, 3);
+	const Assignments pairs = LoadAssignments(data);
+	MeasureTime("columnar counts", [&]() { const Counts counts = CountBoth(pairs); return std::to_string(counts.included) + " " + std::to_string(counts.overlapping); }, 3);
+#elif 0
+	long long score = PartOne(in);
 	std::cout << score << std::endl;  // 448
 #else
-	int score = PartTwo(in);
+	long long score = PartTwo(in);
 	std::cout << score << std::endl;  // 794
 #endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
\ No newline at end of file
@@ -12,8 +12,15 @@
 #include <string>
 #include <ranges>
 #include <string_view>
+#include <initializer_list>
+#include <algorithm>
+#include <cstdint>
+#include <utility>
 
-#include "..\stuffs\Splitter.h"
+#include "..\stuffs\LineReader.h"
+#include "..\stuffs\Benchmark.h"
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
 
 #ifdef _DEBUG
 	#include <assert.h>
@@ -24,99 +31,436 @@
 
 
 
-void PartOne(std::istream& in, std::vector<std::string>& stacks)
+// Stacks of crates, top at the back, as implicit treaps (the in-order of a tree is the stack,
+// bottom to top): moving 'cnt' crates splits them off the top of a tree and merges them on
+// top of the other one, O(log n) whatever 'cnt' is; moving them one at a time reverses their
+// order, that is a lazy flag on the root of the moved tree
+class Crates
 {
-	for (std::string line; std::getline(in, line);)
+public:
+	constexpr Crates()
+		: _nodes(1)  // NIL
 	{
-		if (line.empty())
-			break;
+	}
+
+	// every stack from the top, as in the puzzle: { "NZ", "DCM", "P" }
+	template <typename TStacks>
+	constexpr explicit Crates(const TStacks& stacks)
+		: Crates()
+	{
+		for (std::string_view stack : stacks)
+			_roots.push_back(Build(stack));
+	}
+
+	constexpr Crates(std::initializer_list<std::string_view> stacks)
+		: Crates(std::vector<std::string_view>(stacks))
+	{
+	}
+
+	constexpr size_t Size() const { return _roots.size(); }
 
-		auto sline = split(line, " ");
-		ASSERT(sline.size() == 3);
+	constexpr size_t Height(size_t stack) const { return _nodes[_roots[stack]].size; }
 
-		const int cnt =  std::stoi(sline[0]);
-		const int from = std::stoi(sline[1])-1;
-		const int to =   std::stoi(sline[2])-1;
+	// moves 'cnt' crates one at a time (CrateMover 9000) or all together (CrateMover 9001)
+	constexpr void Move(int cnt, int from, int to, bool all_together)
+	{
+		ASSERT(0 <= from && from < (int)_roots.size() && 0 <= to && to < (int)_roots.size());
+		ASSERT(cnt <= (int)Height(from));
+
+		index_t rest, moved;
+		Split(_roots[from], Height(from) - cnt, rest, moved);
+		if (!all_together && moved != NIL)
+			_nodes[moved].reversed = !_nodes[moved].reversed;
+
+		_roots[from] = rest;
+		_roots[to] = Merge(_roots[to], moved);
+	}
 
-		for (int i = 0; i < cnt; ++i)
+	// Crates on top of the stacks ('-' for empty stacks)
+	constexpr std::string Tops() const
+	{
+		std::string tops;
+		for (const index_t root : _roots)
 		{
-			stacks[to].insert(stacks[to].begin(), stacks[from].front());
-			stacks[from].erase(stacks[from].begin());
+			char top = '-';
+			bool flipped = false;  // pending reversals from the root
+			for (index_t i = root; i != NIL; )
+			{
+				top = _nodes[i].crate;
+				flipped ^= _nodes[i].reversed;
+				i = flipped ? _nodes[i].left : _nodes[i].right;
+			}
+			tops += top;
 		}
+		return tops;
+	}
+
+private:
+	typedef uint32_t index_t;
+	static constexpr index_t NIL = 0;
+
+	struct Node
+	{
+		index_t   left = NIL;
+		index_t   right = NIL;
+		uint32_t  size = 0;          // crates in the subtree
+		uint32_t  priority = 0;      // heap ordered, random: the tree is balanced on average
+		char      crate = 0;
+		bool      reversed = false;  // lazy: the subtree is upside down
+	};
+
+	constexpr void Update(index_t i)
+	{
+		_nodes[i].size = 1 + _nodes[_nodes[i].left].size + _nodes[_nodes[i].right].size;
+	}
+
+	// applies a pending reversal to the children
+	constexpr void Push(index_t i)
+	{
+		Node& node = _nodes[i];
+		if (!node.reversed)
+			return;
+
+		std::swap(node.left, node.right);
+		_nodes[node.left].reversed = !_nodes[node.left].reversed;
+		_nodes[node.right].reversed = !_nodes[node.right].reversed;
+		node.reversed = false;
+		_nodes[NIL].reversed = false;
 	}
+
+	// the first 'cnt' crates (from the bottom) to 'low', the others to 'high'
+	constexpr void Split(index_t i, size_t cnt, index_t& low, index_t& high)
+	{
+		if (i == NIL)
+		{
+			low = high = NIL;
+			return;
+		}
+
+		Push(i);
+		if (_nodes[_nodes[i].left].size >= cnt)
+		{
+			Split(_nodes[i].left, cnt, low, _nodes[i].left);
+			high = i;
+		}
+		else
+		{
+			Split(_nodes[i].right, cnt - _nodes[_nodes[i].left].size - 1, _nodes[i].right, high);
+			low = i;
+		}
+		Update(i);
+	}
+
+	// 'high' on top of 'low'
+	constexpr index_t Merge(index_t low, index_t high)
+	{
+		if (low == NIL || high == NIL)
+			return low != NIL ? low : high;
+
+		if (_nodes[low].priority > _nodes[high].priority)
+		{
+			Push(low);
+			_nodes[low].right = Merge(_nodes[low].right, high);
+			Update(low);
+			return low;
+		}
+		else
+		{
+			Push(high);
+			_nodes[high].left = Merge(low, _nodes[high].left);
+			Update(high);
+			return high;
+		}
+	}
+
+	// a stack from the top, in O(n): a cartesian tree of random priorities, built
+	// bottom to top along its right spine
+	constexpr index_t Build(std::string_view stack)
+	{
+		std::vector<index_t> spine;
+		for (auto it = stack.rbegin(); it != stack.rend(); ++it)
+		{
+			const index_t i = (index_t)_nodes.size();
+			ASSERT(i != NIL && _nodes.size() < UINT32_MAX);
+			_nodes.push_back({ NIL, NIL, 1, (uint32_t)(_rng.Next() >> 32), *it, false });
+
+			index_t last = NIL;
+			while (!spine.empty() && _nodes[spine.back()].priority < _nodes[i].priority)
+			{
+				last = spine.back();
+				spine.pop_back();
+			}
+			_nodes[i].left = last;
+			if (!spine.empty())
+				_nodes[spine.back()].right = i;
+			spine.push_back(i);
+		}
+
+		if (spine.empty())
+			return NIL;
+
+		SetSizes(spine.front());
+		return spine.front();
+	}
+
+	constexpr uint32_t SetSizes(index_t i)
+	{
+		if (i == NIL)
+			return 0;
+
+		_nodes[i].size = 1 + SetSizes(_nodes[i].left) + SetSizes(_nodes[i].right);
+		return _nodes[i].size;
+	}
+
+	std::vector<Node>     _nodes;  // of all the stacks, _nodes[NIL] is a sentinel
+	std::vector<index_t>  _roots;  // of the stacks
+	SyntheticRng          _rng;  // priorities
+};
+
+// The crane program, decoded once: replays need no text processing
+struct Op
+{
+	uint32_t  count;
+	uint16_t  from;  // 0 based
+	uint16_t  to;
+};
+static_assert(sizeof(Op) == 8);
+
+typedef std::vector<Op> program_t;
+
+// "move 1 from 2 to 1" (or just "1 2 1"): the three numbers, whatever is around them
+constexpr Op ParseMove(std::string_view line)
+{
+	uint32_t numbers[3] = {};
+	size_t n = 0;
+	for (size_t i = 0; i < line.size() && n < 3; )
+	{
+		if (line[i] < '0' || '9' < line[i])
+		{
+			++i;
+			continue;
+		}
+
+		for (; i < line.size() && '0' <= line[i] && line[i] <= '9'; ++i)
+			numbers[n] = numbers[n] * 10 + (line[i] - '0');
+		++n;
+	}
+	ASSERT(n == 3 && numbers[1] > 0 && numbers[2] > 0);
+
+	return Op{ numbers[0], (uint16_t)(numbers[1]-1), (uint16_t)(numbers[2]-1) };
+}
+
+constexpr program_t Compile(std::string_view moves)
+{
+	program_t program;
+	ForEachLine(moves, [&](std::string_view line) {
+		if (!line.empty())
+			program.push_back(ParseMove(line));
+	});
+	return program;
 }
 
-void PartTwo(std::istream& in, std::vector<std::string>& stacks)
+// Returns the crates on top
+constexpr std::string Replay(const program_t& program, Crates crates, bool all_together)
 {
-	for (std::string line; std::getline(in, line);)
+	for (const Op& op : program)
+		crates.Move((int)op.count, op.from, op.to, all_together);
+	return crates.Tops();
+}
+
+// Puzzle input, line by line: the drawing of the stacks, a blank line, the moves
+//         [D]
+//     [N] [C]
+//     [Z] [M] [P]
+//      1   2   3
+class PuzzleParser
+{
+public:
+	constexpr void Line(std::string_view line)
 	{
-		if (line.empty())
-			break;
+		if (_drawing)
+		{
+			if (line.empty())
+				_drawing = false;
+			else if (line.find('[') != std::string_view::npos)
+				_rows.emplace_back(line);
+			else
+				_crates = Crates(ParseDrawing(line));  // the numbers of the stacks, under the drawing
+			return;
+		}
 
-		auto sline = split(line, " ");
-		ASSERT(sline.size() == 3);
+		if (!line.empty())
+			_program.push_back(ParseMove(line));
+	}
 
-		const int cnt =  std::stoi(sline[0]);
-		const int from = std::stoi(sline[1])-1;
-		const int to =   std::stoi(sline[2])-1;
+	constexpr const Crates& Stacks() const { return _crates; }
+	constexpr const program_t& Program() const { return _program; }
 
-		stacks[to].insert(stacks[to].begin(), stacks[from].begin(), stacks[from].begin()+cnt);
-		stacks[from].erase(stacks[from].begin(), stacks[from].begin()+cnt);
+private:
+	// crate of the k-th stack at column 1+4k, rows from the top
+	constexpr std::vector<std::string> ParseDrawing(std::string_view numbers) const
+	{
+		size_t num_stacks = 0;
+		for (std::string_view str = numbers; !str.empty(); )
+		{
+			while (!str.empty() && str[0] == ' ')
+				str.remove_prefix(1);
+			if (!str.empty() && ParseInt(str) > 0)
+				++num_stacks;
+		}
+
+		std::vector<std::string> stacks(num_stacks);
+		for (const std::string& row : _rows)
+			for (size_t k = 0; k < num_stacks && 1+4*k < row.size(); ++k)
+				if (row[1+4*k] != ' ')
+					stacks[k] += row[1+4*k];
+		return stacks;
 	}
+
+	bool                      _drawing = true;
+	std::vector<std::string>  _rows;  // of the drawing, until the numbers
+	Crates                    _crates;
+	program_t                 _program;
+};
+
+std::string PartOne(std::istream& in)
+{
+	TRACE_SCOPE("part one", "day05");
+
+	PuzzleParser parser;
+	ForEachLine(in, [&](std::string_view line) { parser.Line(line); });
+	return Replay(parser.Program(), parser.Stacks(), false);
 }
 
-int main()
+std::string PartTwo(std::istream& in)
 {
-#if 0
-	std::istringstream in(
-R"(1 2 1
-3 1 3
-2 2 1
-1 1 2)");
+	TRACE_SCOPE("part two", "day05");
+
+	PuzzleParser parser;
+	ForEachLine(in, [&](std::string_view line) { parser.Line(line); });
+	return Replay(parser.Program(), parser.Stacks(), true);
+}
+
+// Whole input in memory
+constexpr std::string PartOne(std::string_view data)
+{
+	PuzzleParser parser;
+	ForEachLine(data, [&](std::string_view line) { parser.Line(line); });
+	return Replay(parser.Program(), parser.Stacks(), false);
+}
+
+constexpr std::string PartTwo(std::string_view data)
+{
+	PuzzleParser parser;
+	ForEachLine(data, [&](std::string_view line) { parser.Line(line); });
+	return Replay(parser.Program(), parser.Stacks(), true);
+}
+
+// Synthetic crane program on 'num_stacks' stacks of 'height' crates, for throughput:
+// the stacks (from the top) and the moves, that keep all the stacks non empty
+std::pair<std::vector<std::string>, std::string> MakeSynthetic(size_t num_stacks, size_t height, size_t moves, uint64_t seed = 1)
+{
+	SyntheticRng rng(seed);
 
-	std::vector<std::string> stacks =
+	std::vector<std::string> stacks(num_stacks);
+	std::vector<size_t> heights(num_stacks, height);
+	for (std::string& stack : stacks)
+		for (size_t i = 0; i < height; ++i)
+			stack += (char)('A' + rng.Below(26));
+
+	std::string program;
+	for (size_t i = 0; i < moves; ++i)
 	{
-		"NZ",
-		"DCM",
-		"P"
-	};
+		const size_t from = (size_t)rng.Below(num_stacks);
+		const size_t to = (from + 1 + (size_t)rng.Below(num_stacks - 1)) % num_stacks;
+		if (heights[from] < 2)
+			continue;
+
+		const size_t cnt = 1 + (size_t)rng.Below(std::min<size_t>(heights[from] - 1, rng.Below(2) ? 10 : heights[from] - 1));
+		heights[from] -= cnt;
+		heights[to] += cnt;
+		program += std::to_string(cnt) + ' ' + std::to_string(from+1) + ' ' + std::to_string(to+1) + '\n';
+	}
+
+	return std::make_pair(std::move(stacks), std::move(program));
+}
+
+// sample of the puzzle, solved at compile time
+constexpr std::string_view SAMPLE =
+R"(    [D]    
+[N] [C]    
+[Z] [M] [P]
+ 1   2   3 
+
+move 1 from 2 to 1
+move 3 from 1 to 3
+move 2 from 2 to 1
+move 1 from 1 to 2)";
+
+static_assert(PartOne(SAMPLE) == "CMZ");
+static_assert(PartTwo(SAMPLE) == "MCD");
+
+// moving and splitting segments back and forth: the same as the naive stacks
+constexpr std::string_view SHUFFLE =
+R"(2 1 2
+4 2 3
+1 3 1
+3 3 2
+2 2 1
+5 1 3
+6 3 2
+1 2 1)";
+
+constexpr std::string NaiveTops(std::string_view moves, std::initializer_list<std::string_view> initial_stacks, bool all_together)
+{
+	std::vector<std::string> stacks;
+	for (std::string_view stack : initial_stacks)
+		stacks.emplace_back(stack);
+
+	ForEachLine(moves, [&](std::string_view line) {
+		const int cnt = ParseInt(line), from = ParseInt(line)-1, to = ParseInt(line)-1;
+		std::string crates = stacks[from].substr(0, cnt);
+		if (!all_together)
+			crates = std::string(crates.rbegin(), crates.rend());
+		stacks[from].erase(0, cnt);
+		stacks[to].insert(0, crates);
+	});
+
+	std::string tops;
+	for (const auto& stack : stacks)
+		tops += stack.empty() ? '-' : stack[0];
+	return tops;
+}
+
+static_assert(Replay(Compile(SHUFFLE), { "ABCD", "EFG", "HI" }, false) == NaiveTops(SHUFFLE, { "ABCD", "EFG", "HI" }, false));
+static_assert(Replay(Compile(SHUFFLE), { "ABCD", "EFG", "HI" }, true) == NaiveTops(SHUFFLE, { "ABCD", "EFG", "HI" }, true));
+
+int main()
+{
+#if 0
+	std::istringstream in{std::string(SAMPLE)};
 #else
-	std::ifstream in("input1.txt");
-	//     [P]                 [Q]     [T]
-	// [F] [N]             [P] [L]     [M]
-	// [H] [T] [H]         [M] [H]     [Z]
-	// [M] [C] [P]     [Q] [R] [C]     [J]
-	// [T] [J] [M] [F] [L] [G] [R]     [Q]
-	// [V] [G] [D] [V] [G] [D] [N] [W] [L]
-	// [L] [Q] [S] [B] [H] [B] [M] [L] [D]
-	// [D] [H] [R] [L] [N] [W] [G] [C] [R]
-	std::vector<std::string> stacks =
-	{
-		"FHMTVLD",
-		"PNTCJGQH",
-		"HPMDSR",
-		"FVBL",
-		"QLGHN",
-		"PMRGDBW",
-		"QLHCRNMG",
-		"WLC",
-		"TMZJQLDR",
-	};
+	std::ifstream in("input1--ORIGINAL.txt");  // input1.txt: just the moves
 #endif
 
 #if 0
-	PartOne(in, stacks);
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) { return PartTwo(in); });
+#elif 0
+	// 10^7 moves on stacks of 10^6 crates: decoded once, replayed by both the cranes
+	const auto [stacks, moves] = MakeSynthetic(9, 1'000'000, 10'000'000);
+	const Crates synthetic(stacks);
+	program_t program;
+	MeasureTime("compile", [&]() { program = Compile(moves); return program.size(); }, 1);
+	MeasureTime("CrateMover 9000", [&]() { return Replay(program, synthetic, false); }, 1);
+	MeasureTime("CrateMover 9001", [&]() { return Replay(program, synthetic, true); }, 1);
+#elif 0
+	std::string tops = PartOne(in);
+	std::cout << tops << std::endl;  // HNSNMTLHQ
 #else
-	PartTwo(in, stacks);
+	std::string tops = PartTwo(in);
+	std::cout << tops << std::endl;  // RNLFDJMCT
 #endif
 
-	for (auto v : stacks)
-	{
-		if (v.empty())
-			std::cout << '-';
-		else
-			std::cout << v[0];
-	}
-
-	std::cout << std::endl;  // HNSNMTLHQ  /  RNLFDJMCT
-}
\ No newline at end of file
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
+}
@@ -12,7 +12,15 @@
 #include <string>
 #include <ranges>
 #include <string_view>
-#include <set>
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+
+#include "..\stuffs\LineReader.h"
+#include "..\stuffs\BinaryInput.h"
+#include "..\stuffs\Benchmark.h"
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
 
 #ifdef _DEBUG
 	#include <assert.h>
@@ -23,28 +31,82 @@
 
 
 
-size_t FindMarker(const std::string& buff, int len)
+// Ends of the first windows of 'len' different characters, for several lengths in a single
+// pass: the characters after the last repeat are all different, so a window of 'len' ends
+// wherever that run reaches 'len'. The last position of every character moves the start
+// of the run forward, O(1) per character, whatever the lengths
+class MarkerFinder
 {
-	if (buff.size() < len)
+public:
+	constexpr MarkerFinder(std::initializer_list<size_t> lengths)
+		: _lengths(lengths)
+		, _markers(lengths.size(), 0)
 	{
-		ASSERT(false);
+		for (size_t k = 0; k < _lengths.size(); ++k)
+			_order.push_back(k);
+		std::sort(_order.begin(), _order.end(), [this](size_t l, size_t r) { return _lengths[l] < _lengths[r]; });
 	}
 
-	for (size_t i = 0; i < buff.size()- len; ++i)
+	// Returns true once all the markers are found
+	constexpr bool Feed(std::string_view data)
 	{
-		std::set sub(buff.begin()+i, buff.begin()+i+len);
-		if (sub.size() == len)
+		if (Done())
+			return true;
+
+		// locals: the stores into _last cannot alias them
+		uint64_t pos = _pos, start = _start;
+		size_t next_len = _lengths[_order[_next]];
+		for (const char ch : data)
 		{
-			return i+len;
+			uint64_t& last = _last[(unsigned char)ch];
+			start = std::max(start, last);
+			last = ++pos;
+
+			if (pos - start < next_len)
+				continue;
+
+			while (_next < _order.size() && _lengths[_order[_next]] <= pos - start)
+				_markers[_order[_next++]] = pos;
+			if (Done())
+				break;
+			next_len = _lengths[_order[_next]];
 		}
+
+		_pos = pos;
+		_start = start;
+		return Done();
 	}
 
-	ASSERT(false);
-	return 0;
+	constexpr bool Done() const { return _next == _order.size(); }
+
+	// end of the first window of the k-th length (0: not found, yet)
+	constexpr uint64_t Marker(size_t k) const { return _markers[k]; }
+
+	constexpr uint64_t Position() const { return _pos; }
+
+private:
+	std::vector<size_t>    _lengths;
+	std::vector<size_t>    _order;        // of the lengths, shortest first
+	std::vector<uint64_t>  _markers;
+	size_t                 _next = 0;     // in _order: the first length not found, yet
+	uint64_t               _last[256] = {};  // 1 + position of the last occurrence, per character
+	uint64_t               _start = 0;    // of the run of different characters
+	uint64_t               _pos = 0;      // characters so far
+};
+
+// End of the first 'len' characters all different
+constexpr size_t FindMarker(std::string_view buff, int len)
+{
+	MarkerFinder finder{ (size_t)len };
+	finder.Feed(buff);
+	ASSERT(finder.Done());
+	return (size_t)finder.Marker(0);
 }
 
 void FindMarker(std::istream& in, int len)
 {
+	TRACE_SCOPE(len == 4 ? "part one" : "part two", "day06");
+
 	for (std::string line; std::getline(in, line);)
 	{
 		if (line.empty())
@@ -54,32 +116,146 @@ void FindMarker(std::istream& in, int len)
 	}
 }
 
-void PartTwo(std::istream& in)
+// Both the parts in a single pass, per line
+void FindMarkers(std::istream& in)
 {
+	TRACE_SCOPE("both parts", "day06");
+
+	for (std::string line; std::getline(in, line);)
+	{
+		if (line.empty())
+			break;
+
+		MarkerFinder finder{ 4, 14 };
+		finder.Feed(line);
+		std::cout << finder.Marker(0) << " " << finder.Marker(1) << std::endl;
+	}
 }
 
-int main()
+// Markers of a signal of any length (up to the first end of line), read in chunks of fixed
+// size: the state of the windows is carried from a chunk to the next one, memory is O(chunk)
+MarkerFinder StreamMarkers(std::istream& in, std::initializer_list<size_t> lengths, size_t chunk_size = 1 << 16)
 {
-#if 0
-	std::istringstream in(
+	MarkerFinder finder(lengths);
+
+	std::vector<char> buffer(chunk_size);
+	while (in && !finder.Done())
+	{
+		in.read(buffer.data(), buffer.size());
+		const std::string_view chunk(buffer.data(), (size_t)in.gcount());
+		if (chunk.empty())
+			break;
+
+		const size_t eol = chunk.find_first_of("\r\n");
+		finder.Feed(chunk.substr(0, eol));
+		if (eol != std::string_view::npos)
+			break;
+	}
+	return finder;
+}
+
+// Markers of a mapped signal: the pages are read by the system, as they are scanned
+MarkerFinder MappedMarkers(const MappedFile& file, std::initializer_list<size_t> lengths)
+{
+	std::string_view signal(file.Data(), file.Size());
+	signal = signal.substr(0, signal.find_first_of("\r\n"));
+
+	MarkerFinder finder(lengths);
+	finder.Feed(signal);
+	return finder;
+}
+
+// Synthetic signal of 'size' random characters out of 'alphabet', for throughput
+std::string MakeSynthetic(size_t size, size_t alphabet = 26, uint64_t seed = 1)
+{
+	SyntheticRng rng(seed);
+	std::string data(size, 0);
+	for (char& ch : data)
+		ch = (char)('a' + rng.Below(alphabet));
+	return data;
+}
+
+// sample of the puzzle, solved at compile time
+constexpr std::string_view SAMPLE =
 R"(bvwbjplbgvbhsrlpgdmjqwftvncz
 nppdvjthqldpwncqszvftbrmjlhg
 nznrnfrfntjfmvfwmzdfjlvtqnbhcprs
-zcfzfwzzqfrljwzlrfnpqdbhtmscgvjw)");
-#elif 0
-	std::istringstream in(
+zcfzfwzzqfrljwzlrfnpqdbhtmscgvjw)";
+
+static_assert(FindMarker(NthLine(SAMPLE, 0),  4) ==  5);
+static_assert(FindMarker(NthLine(SAMPLE, 1),  4) ==  6);
+static_assert(FindMarker(NthLine(SAMPLE, 2),  4) == 10);
+static_assert(FindMarker(NthLine(SAMPLE, 3),  4) == 11);
+
+// more samples, solved at compile time
+constexpr std::string_view SAMPLE2 =
 R"(mjqjpqmgbljsphdztnvjfqwrcgsmlb
 bvwbjplbgvbhsrlpgdmjqwftvncz
 nppdvjthqldpwncqszvftbrmjlhg
 nznrnfrfntjfmvfwmzdfjlvtqnbhcprsg
-zcfzfwzzqfrljwzlrfnpqdbhtmscgvjw)");
+zcfzfwzzqfrljwzlrfnpqdbhtmscgvjw)";
+
+static_assert(FindMarker(NthLine(SAMPLE2, 0), 14) == 19);
+static_assert(FindMarker(NthLine(SAMPLE2, 1), 14) == 23);
+static_assert(FindMarker(NthLine(SAMPLE2, 2), 14) == 23);
+static_assert(FindMarker(NthLine(SAMPLE2, 3), 14) == 29);
+static_assert(FindMarker(NthLine(SAMPLE2, 4), 14) == 26);
+
+// all the lengths at once
+constexpr bool CheckMarkers(std::string_view line, uint64_t start_of_packet, uint64_t start_of_message)
+{
+	MarkerFinder finder{ 14, 4 };
+	return finder.Feed(line) && finder.Marker(0) == start_of_message && finder.Marker(1) == start_of_packet;
+}
+
+static_assert(CheckMarkers(NthLine(SAMPLE2, 0),  7, 19));
+static_assert(CheckMarkers(NthLine(SAMPLE2, 4), 11, 26));
+
+int main()
+{
+#if 0
+	std::istringstream in{std::string(SAMPLE)};
+#elif 0
+	std::istringstream in{std::string(SAMPLE2)};
 #else
 	std::ifstream in("input1.txt");
 #endif
 
 #if 0
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) {
+		std::string line;
+		std::getline(in, line);
+		return FindMarker(line, 14);
+	});
+#elif 0
+	// multi-GB signal, windows up to the whole alphabet (never found: the whole signal is scanned)
+	const std::string signal = MakeSynthetic((size_t)2 << 30);
+	MeasureTime("4, 14, 26", [&]() {
+		MarkerFinder finder{ 4, 14, 26 };
+		finder.Feed(signal);
+		return std::to_string(finder.Marker(0)) + " " + std::to_string(finder.Marker(1)) + " " + std::to_string(finder.Marker(2));
+	}, 3);
+#elif 0
+	// streaming a signal of any length from stdin: throughput and peak memory
+	MeasureStream(std::cin, [](std::istream& in) {
+		const MarkerFinder finder = StreamMarkers(in, { 4, 14 });
+		return std::to_string(finder.Marker(0)) + " " + std::to_string(finder.Marker(1));
+	});
+#elif 0
+	// mapped signal, of any length
+	MappedFile file;
+	if (!file.Open("input1.txt"))
+		return 1;
+	const MarkerFinder finder = MappedMarkers(file, { 4, 14 });
+	std::cout << finder.Marker(0) << " " << finder.Marker(1) << std::endl;  // 1920 2334
+#elif 0
+	FindMarkers(in);  // 1920 2334
+#elif 0
 	FindMarker(in, 4);  // 1920
 #else
 	FindMarker(in, 14);  // 2334
 #endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
\ No newline at end of file
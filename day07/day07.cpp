@@ -14,8 +14,15 @@
 #include <string_view>
 #include <algorithm>
 #include <functional>
+#include <unordered_map>
+#include <span>
+#include <cstdint>
 
 #include "..\stuffs\Splitter.h"
+#include "..\stuffs\LineReader.h"
+#include "..\stuffs\Benchmark.h"
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
 
 #ifdef _DEBUG
 	#include <assert.h>
@@ -46,13 +53,15 @@ public:
 
 	Directory* Parent() const { return pParent; }
 
-	virtual int Size() const = 0;
+	virtual long long Size() const = 0;
 	virtual void Visit(std::function<void(const FS_Element*, int)> functor, int level = 0) const
 	{
 		functor(this, level);
 	}
 
 private:
+	friend class Directory;  // moving a directory moves the parent of its content
+
 	std::string name;
 	Directory*  pParent;
 };
@@ -67,7 +76,7 @@ public:
 	{
 	}
 
-	virtual int Size() const override
+	virtual long long Size() const override
 	{
 		return file_size;
 	}
@@ -85,8 +94,34 @@ public:
 	{
 	}
 
+	Directory(Directory&& other)
+		: FS_Element(other)
+		, content(std::move(other.content))
+		, total_size(other.total_size)
+		, subdirs(std::move(other.subdirs))
+		, indexed(other.indexed)
+	{
+		for (const auto e : content)
+			e->pParent = this;
+	}
+
+	// large directories are indexed (on first use): O(1) instead of a scan of the content
 	Directory* Child(const std::string& name)
 	{
+		if (!indexed && content.size() > INDEX_MIN_ENTRIES)
+		{
+			for (const auto e : content)
+				if (Directory* d = dynamic_cast<Directory*>(e))
+					subdirs.emplace(d->Name(), d);
+			indexed = true;
+		}
+
+		if (indexed)
+		{
+			const auto it = subdirs.find(name);
+			return it != subdirs.end() ? it->second : nullptr;
+		}
+
 		for (const auto e : content)
 		{
 			Directory* d = dynamic_cast<Directory*>(e);
@@ -104,19 +139,53 @@ public:
 			e->Visit(functor, level + 1);
 	}
 
-	virtual int Size() const override
+	// cached: O(1)
+	virtual long long Size() const override
+	{
+		return total_size;
+	}
+
+	// the size of the file is added to all the directories up to the root: O(depth)
+	void AddFile(const std::string& name, int size)
+	{
+		content.push_back(new File(name, size, this));
+		for (Directory* d = this; d; d = d->Parent())
+			d->total_size += size;
+	}
+
+	// while parsing: the size of the file is added to this directory only, the subtrees
+	// are summed once, at the end (see SumSubtrees)
+	void AppendFile(const std::string& name, int size)
+	{
+		content.push_back(new File(name, size, this));
+		total_size += size;
+	}
+
+	// bottom-up, once after AppendFile's: O(n)
+	long long SumSubtrees()
 	{
-		int total = 0;
 		for (const auto e : content)
-			total += e->Size();
-		return total;
+			if (Directory* d = dynamic_cast<Directory*>(e))
+				total_size += d->SumSubtrees();
+		return total_size;
 	}
 
-	void AddFile(const std::string& name, int size) { content.push_back(new File(name, size, this)); }
-	void AddDir(const std::string& name)            { content.push_back(new Directory(name, this)); }
+	void AddDir(const std::string& name)
+	{
+		Directory* d = new Directory(name, this);
+		content.push_back(d);
+		if (indexed)
+			subdirs.emplace(name, d);
+	}
 
 private:
+	static constexpr size_t INDEX_MIN_ENTRIES = 8;
+
 	std::vector<FS_Element*>  content;
+	long long                 total_size = 0;  // of the whole subtree
+
+	std::unordered_map<std::string, Directory*>  subdirs;  // by name, once 'indexed'
+	bool                                         indexed = false;
 };
 
 std::string FS_Element::FullPathName() const { return (pParent ? pParent->FullPathName() : std::string()) + '/' + name; }
@@ -127,6 +196,8 @@ std::string FS_Element::FullPathName() const { return (pParent ? pParent->FullPa
 
 Directory ParseFS(std::istream& in)
 {
+	TRACE_SCOPE("parse", "day07");
+
 	Directory root("", nullptr);
 	Directory* pCurr_wd = nullptr;
 
@@ -199,10 +270,12 @@ Directory ParseFS(std::istream& in)
 			ASSERT(parts.size() == 2 && !parts[1].empty());
 
 			ASSERT(is_ls);
-			pCurr_wd->AddFile(parts[1], value);
+			pCurr_wd->AppendFile(parts[1], value);
 		}
 	}
 
+	root.SumSubtrees();
+
 	if (0)
 	{
 		auto print = [](const FS_Element* e, int level) {
@@ -224,19 +297,21 @@ Directory ParseFS(std::istream& in)
 	return std::move(root);
 }
 
-int PartOne(std::istream & in)
+long long PartOne(std::istream & in)
 {
+	TRACE_SCOPE("part one", "day07");
+
 	Directory root = ParseFS(in);
 
 	const int THRESHOLD = 100000;
-	int total = 0;
+	long long total = 0;
 	{
 		auto summarize = [&](const FS_Element* e, int level) {
 
 			if (nullptr == dynamic_cast<const Directory*>(e))
 				return;
 
-			int size = e->Size();
+			long long size = e->Size();
 			if (size <= THRESHOLD)
 				total += size;
 		};
@@ -246,26 +321,25 @@ int PartOne(std::istream & in)
 	return total;
 }
 
-int PartTwo(std::istream& in)
+long long PartTwo(std::istream& in, const long long TOTALDISK = 70000000, const long long NEEDED = 30000000)
 {
-	Directory root = ParseFS(in);
+	TRACE_SCOPE("part two", "day07");
 
-	const int TOTALDISK = 70000000;
-	const int NEEDED =  30000000;
+	Directory root = ParseFS(in);
 
-	const int totalFs = root.Size();
-	const int available = TOTALDISK - totalFs;
+	const long long totalFs = root.Size();
+	const long long available = TOTALDISK - totalFs;
 	ASSERT(0 <= available && available < NEEDED);
 
 	const Directory* pBestDir = nullptr;
-	int bestSize = 0;
+	long long bestSize = 0;
 	{
 		auto finder = [&](const FS_Element* e, int level) {
 
 			if (nullptr == dynamic_cast<const Directory*>(e))
 				return;
 
-			int size = e->Size();
+			long long size = e->Size();
 			if (available + size < NEEDED)
 				return;
 
@@ -280,6 +354,373 @@ int PartTwo(std::istream& in)
 	}
 	return bestSize;
 }
+// The same filesystem as a flat tree: one array per field, nodes referred to by index. The
+// nodes are renumbered in pre-order once the tree is complete (see Finalize), so that
+// visiting the whole tree is a linear scan of the arrays
+class FlatFS
+{
+public:
+	typedef uint32_t index_t;
+	static constexpr index_t NONE = UINT32_MAX;
+	static constexpr index_t ROOT = 0;
+
+	enum Kind : uint8_t { DIR, FILE };
+
+	FlatFS()
+	{
+		Add(NONE, DIR, "", 0);
+	}
+
+	index_t AddDir(index_t parent, std::string_view name)            { return Add(parent, DIR, name, 0); }
+	index_t AddFile(index_t parent, std::string_view name, int size) { return Add(parent, FILE, name, size); }
+
+	// sub-directory of 'dir', NONE if missing: names are compared as interned ids, and the
+	// directories with more than a handful of entries are hashed (on first use), O(1)
+	index_t Child(index_t dir, std::string_view name)
+	{
+		const auto id = _ids.find(name);
+		if (id == _ids.end())
+			return NONE;
+
+		if (!_indexed[dir] && _child_count[dir] > INDEX_MIN_ENTRIES)
+		{
+			for (index_t i = _first_child[dir]; i != NONE; i = _next_sibling[i])
+				if (_kind[i] == DIR)
+					_subdirs.emplace(Key(dir, _name[i]), i);
+			_indexed[dir] = true;
+		}
+
+		if (_indexed[dir])
+		{
+			const auto it = _subdirs.find(Key(dir, id->second));
+			return it != _subdirs.end() ? it->second : NONE;
+		}
+
+		for (index_t i = _first_child[dir]; i != NONE; i = _next_sibling[i])
+			if (_kind[i] == DIR && _name[i] == id->second)
+				return i;
+		return NONE;
+	}
+
+	size_t           Count() const               { return _kind.size(); }
+	index_t          Parent(index_t i) const     { return _parent[i]; }
+	Kind             GetKind(index_t i) const    { return (Kind)_kind[i]; }
+	std::string_view Name(index_t i) const       { return std::string_view(_names.data() + _name_offset[_name[i]]); }
+	long long        Size(index_t i) const       { return _size[i]; }
+
+	// sizes of the directories, bottom up, and pre-order numbering: O(n)
+	void Finalize()
+	{
+		// a parent is always added before its children: one backward scan sums the subtrees
+		for (index_t i = (index_t)Count() - 1; i > ROOT; --i)
+			_size[_parent[i]] += _size[i];
+
+		std::vector<index_t> order;  // old indexes, in pre-order
+		order.reserve(Count());
+		for (index_t i = ROOT; i != NONE; )
+		{
+			order.push_back(i);
+			if (_first_child[i] != NONE)
+			{
+				i = _first_child[i];
+				continue;
+			}
+			while (i != NONE && _next_sibling[i] == NONE)
+				i = _parent[i];
+			if (i != NONE)
+				i = _next_sibling[i];
+		}
+		ASSERT(order.size() == Count());
+
+		std::vector<index_t> renumber(Count());
+		for (index_t k = 0; k < (index_t)order.size(); ++k)
+			renumber[order[k]] = k;
+		auto map = [&](index_t i) { return i == NONE ? NONE : renumber[i]; };
+
+		Permute(_parent, order, map);
+		Permute(_first_child, order, map);
+		Permute(_next_sibling, order, map);
+		Permute(_kind, order, [](uint8_t kind) { return kind; });
+		Permute(_name, order, [](uint32_t name) { return name; });
+		Permute(_size, order, [](long long size) { return size; });
+		Permute(_child_count, order, [](uint32_t count) { return count; });
+		Permute(_indexed, order, [](bool indexed) { return indexed; });
+		_last_child.clear();
+		_last_child.shrink_to_fit();
+
+		std::unordered_map<uint64_t, index_t> subdirs;
+		for (const auto& [key, i] : _subdirs)
+			subdirs.emplace(Key(map((index_t)(key >> 32)), (uint32_t)key), map(i));
+		_subdirs = std::move(subdirs);
+	}
+
+	// func(index), in pre-order: parents before children
+	template <typename TFunc>
+	void Visit(TFunc func) const
+	{
+		for (index_t i = 0; i < (index_t)Count(); ++i)
+			func(i);
+	}
+
+private:
+	index_t Add(index_t parent, Kind kind, std::string_view name, int size)
+	{
+		const index_t i = (index_t)Count();
+		_parent.push_back(parent);
+		_first_child.push_back(NONE);
+		_next_sibling.push_back(NONE);
+		_last_child.push_back(NONE);
+		_kind.push_back(kind);
+		_name.push_back(Intern(name));
+		_size.push_back(size);
+		_child_count.push_back(0);
+		_indexed.push_back(false);
+
+		if (parent != NONE)  // children in order of listing
+		{
+			if (_last_child[parent] == NONE)
+				_first_child[parent] = i;
+			else
+				_next_sibling[_last_child[parent]] = i;
+			_last_child[parent] = i;
+
+			++_child_count[parent];
+			if (_indexed[parent] && kind == DIR)
+				_subdirs.emplace(Key(parent, _name[i]), i);
+		}
+		return i;
+	}
+
+	// id of the name, the same for the same name
+	uint32_t Intern(std::string_view name)
+	{
+		const auto it = _ids.find(name);
+		if (it != _ids.end())
+			return it->second;
+
+		const uint32_t id = (uint32_t)_name_offset.size();
+		_name_offset.push_back((uint32_t)_names.size());
+		_names += name;
+		_names += '\0';
+		_ids.emplace(std::string(name), id);
+		return id;
+	}
+
+	static uint64_t Key(index_t dir, uint32_t name) { return ((uint64_t)dir << 32) | name; }
+
+	// std::string keys, std::string_view lookups
+	struct NameHash
+	{
+		using is_transparent = void;
+		size_t operator () (std::string_view name) const { return std::hash<std::string_view>()(name); }
+	};
+
+	static constexpr uint32_t INDEX_MIN_ENTRIES = 8;
+
+	template <typename T, typename TMap>
+	static void Permute(std::vector<T>& v, const std::vector<index_t>& order, TMap map)
+	{
+		std::vector<T> permuted(v.size());
+		for (size_t k = 0; k < order.size(); ++k)
+			permuted[k] = map(v[order[k]]);
+		v = std::move(permuted);
+	}
+
+	std::vector<index_t>    _parent;
+	std::vector<index_t>    _first_child;
+	std::vector<index_t>    _next_sibling;
+	std::vector<index_t>    _last_child;  // while building
+	std::vector<uint8_t>    _kind;
+	std::vector<uint32_t>   _name;        // interned id
+	std::vector<long long>  _size;        // of the file, or of the whole subtree
+	std::vector<uint32_t>   _child_count;
+	std::vector<bool>       _indexed;     // the sub-directories are in _subdirs
+
+	std::string                                                             _names;        // pool of the names, '\0' terminated
+	std::vector<uint32_t>                                                   _name_offset;  // in _names, by id
+	std::unordered_map<std::string, uint32_t, NameHash, std::equal_to<>>   _ids;          // by name
+	std::unordered_map<uint64_t, index_t>                                   _subdirs;      // by Key(dir, name id)
+};
+
+FlatFS ParseFlatFS(std::istream& in)
+{
+	TRACE_SCOPE("parse", "day07");
+
+	FlatFS fs;
+	FlatFS::index_t curr_wd = FlatFS::NONE;
+
+	for (std::string line; std::getline(in, line);)
+	{
+		if (line.empty())
+			break;
+
+		std::string_view str(line);
+		if (str.starts_with("$ cd "))
+		{
+			const std::string_view path = str.substr(5);
+			if (path == "/")
+				curr_wd = FlatFS::ROOT;
+			else if (path == "..")
+				curr_wd = (fs.Parent(curr_wd) != FlatFS::NONE) ? fs.Parent(curr_wd) : curr_wd;
+			else
+			{
+				ASSERT(curr_wd != FlatFS::NONE && fs.Child(curr_wd, path) != FlatFS::NONE);
+				curr_wd = fs.Child(curr_wd, path);
+			}
+		}
+		else if (str.starts_with("$ ls"))
+		{
+		}
+		else if (str.starts_with("dir "))
+		{
+			fs.AddDir(curr_wd, str.substr(4));
+		}
+		else
+		{
+			const int size = ParseInt(str);
+			fs.AddFile(curr_wd, str, size);
+		}
+	}
+
+	fs.Finalize();
+	return fs;
+}
+
+long long PartOne(const FlatFS& fs)
+{
+	const int THRESHOLD = 100000;
+	long long total = 0;
+	fs.Visit([&](FlatFS::index_t i) {
+		if (fs.GetKind(i) == FlatFS::DIR && fs.Size(i) <= THRESHOLD)
+			total += fs.Size(i);
+	});
+	return total;
+}
+
+long long PartTwo(const FlatFS& fs, const long long TOTALDISK = 70000000, const long long NEEDED = 30000000)
+{
+	const long long available = TOTALDISK - fs.Size(FlatFS::ROOT);
+	ASSERT(0 <= available && available < NEEDED);
+
+	long long bestSize = -1;
+	fs.Visit([&](FlatFS::index_t i) {
+		if (fs.GetKind(i) == FlatFS::DIR && available + fs.Size(i) >= NEEDED && (bestSize < 0 || bestSize > fs.Size(i)))
+			bestSize = fs.Size(i);
+	});
+	return bestSize;
+}
+
+// Sizes of all the directories, sorted, with their prefix sums: built once in O(n log n),
+// then every threshold or best-fit question is a binary search
+class SizeIndex
+{
+public:
+	explicit SizeIndex(const FlatFS& fs)
+	{
+		fs.Visit([&](FlatFS::index_t i) {
+			if (fs.GetKind(i) == FlatFS::DIR)
+				_sizes.push_back(fs.Size(i));
+		});
+		std::sort(_sizes.begin(), _sizes.end());
+
+		_prefix.resize(_sizes.size() + 1, 0);
+		std::partial_sum(_sizes.begin(), _sizes.end(), _prefix.begin() + 1);
+	}
+
+	size_t Count() const { return _sizes.size(); }
+
+	// total size of the directories of size <= threshold: O(log n)
+	long long SumAtMost(long long threshold) const
+	{
+		const auto end = std::upper_bound(_sizes.begin(), _sizes.end(), threshold);
+		return _prefix[end - _sizes.begin()];
+	}
+
+	// size of the smallest directory of size >= needed, -1 if none: O(log n)
+	long long SmallestAtLeast(long long needed) const
+	{
+		const auto it = std::lower_bound(_sizes.begin(), _sizes.end(), needed);
+		return it != _sizes.end() ? *it : -1;
+	}
+
+	// batches of questions
+	std::vector<long long> SumAtMost(std::span<const long long> thresholds) const
+	{
+		std::vector<long long> sums(thresholds.size());
+		for (size_t i = 0; i < thresholds.size(); ++i)
+			sums[i] = SumAtMost(thresholds[i]);
+		return sums;
+	}
+
+	std::vector<long long> SmallestAtLeast(std::span<const long long> needed) const
+	{
+		std::vector<long long> sizes(needed.size());
+		for (size_t i = 0; i < needed.size(); ++i)
+			sizes[i] = SmallestAtLeast(needed[i]);
+		return sizes;
+	}
+
+	long long Used() const { return _sizes.empty() ? 0 : _sizes.back(); }  // the root is the largest
+
+private:
+	std::vector<long long>  _sizes;   // ascending
+	std::vector<long long>  _prefix;  // _prefix[k]: sum of the first k sizes
+};
+
+long long PartOne(const SizeIndex& index)
+{
+	return index.SumAtMost(100000);
+}
+
+long long PartTwo(const SizeIndex& index, const long long TOTALDISK = 70000000, const long long NEEDED = 30000000)
+{
+	const long long available = TOTALDISK - index.Used();
+	ASSERT(0 <= available && available < NEEDED);
+
+	return index.SmallestAtLeast(NEEDED - available);
+}
+
+// Synthetic "ls" transcript of (about) 'entries' files and directories: a chain of 'depth'
+// nested directories, every one with its files and a small sibling directory
+std::string MakeSynthetic(size_t entries, size_t depth, uint64_t seed = 1)
+{
+	SyntheticRng rng(seed);
+
+	const size_t files_per_level = std::max<size_t>(1, entries / depth);
+
+	std::string transcript = "$ cd /\n";
+	for (size_t level = 0; level < depth; ++level)
+	{
+		transcript += "$ ls\n";
+		transcript += "dir side\n";
+		if (level + 1 < depth)
+			transcript += "dir d" + std::to_string(level) + "\n";
+		for (size_t i = 0; i < files_per_level; ++i)
+			transcript += std::to_string(1 + rng.Below(100000)) + " f" + std::to_string(i) + "\n";
+
+		transcript += "$ cd side\n$ ls\n";
+		for (size_t i = 0; i < 3; ++i)
+			transcript += std::to_string(1 + rng.Below(100000)) + " s" + std::to_string(i) + "\n";
+		transcript += "$ cd ..\n";
+
+		if (level + 1 < depth)
+			transcript += "$ cd d" + std::to_string(level) + "\n";
+	}
+	return transcript;
+}
+
+// Synthetic "ls" transcript of a single wide directory: 'dirs' sub-directories, every one
+// visited with a "cd" (a linear lookup of the children is quadratic)
+std::string MakeWide(size_t dirs)
+{
+	std::string transcript = "$ cd /\n$ ls\n";
+	for (size_t i = 0; i < dirs; ++i)
+		transcript += "dir x" + std::to_string(i) + "\n";
+	for (size_t i = 0; i < dirs; ++i)
+		transcript += "$ cd x" + std::to_string(i) + "\n$ ls\n" + std::to_string(1 + i % 1000) + " f\n$ cd ..\n";
+	return transcript;
+}
+
 int main()
 {
 #if 0
@@ -312,10 +753,86 @@ $ ls
 #endif
 
 #if 0
-	int size = PartOne(in);
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) { return PartTwo(in); });
+#elif 0
+	// synthetic transcript: 10^6 entries, 1000 nested directories
+	const std::string transcript = MakeSynthetic(1'000'000, 1000);
+	MeasureTime("parse", [&]() { std::istringstream is(transcript); return ParseFS(is).Size(); }, 3);
+	MeasureTime("part one", [&]() { std::istringstream is(transcript); return PartOne(is); }, 3);
+	MeasureTime("part two", [&]() { std::istringstream is(transcript); return PartTwo(is, 100LL << 32, 1LL << 32); }, 3);
+
+	// files added after parsing, at the bottom of the tree
+	std::istringstream is(transcript);
+	Directory root = ParseFS(is);
+	Directory* pDeepest = &root;
+	for (size_t level = 0; level + 1 < 1000; ++level)
+		pDeepest = pDeepest->Child("d" + std::to_string(level));
+	MeasureTime("10^5 files at depth 1000", [&]() {
+		for (int i = 0; i < 100000; ++i)
+			pDeepest->AddFile("new" + std::to_string(i), 1);
+		return root.Size();
+	}, 1);
+#elif 0
+	// pointers and virtual calls vs flat arrays, on the synthetic transcript
+	const std::string transcript = MakeSynthetic(1'000'000, 1000);
+	MeasureTime("tree: parse + both parts", [&]() {
+		std::istringstream is(transcript);
+		const Directory root = ParseFS(is);
+		long long total = 0;
+		root.Visit([&](const FS_Element* e, int) { if (dynamic_cast<const Directory*>(e) && e->Size() <= 100000) total += e->Size(); });
+		return total;
+	}, 3);
+	MeasureTime("flat: parse + both parts", [&]() {
+		std::istringstream is(transcript);
+		const FlatFS fs = ParseFlatFS(is);
+		return std::to_string(PartOne(fs)) + " " + std::to_string(PartTwo(fs, 100LL << 32, 1LL << 32));
+	}, 3);
+
+	std::istringstream tree_in(transcript), flat_in(transcript);
+	const Directory root = ParseFS(tree_in);
+	const FlatFS fs = ParseFlatFS(flat_in);
+	MeasureTime("tree: visit", [&]() { long long dirs = 0; root.Visit([&](const FS_Element* e, int) { dirs += dynamic_cast<const Directory*>(e) != nullptr; }); return dirs; });
+	MeasureTime("flat: visit", [&]() { long long dirs = 0; fs.Visit([&](FlatFS::index_t i) { dirs += fs.GetKind(i) == FlatFS::DIR; }); return dirs; });
+#elif 0
+	// "cd" into the sub-directories of a directory of 10^5 entries
+	const std::string transcript = MakeWide(100'000);
+	MeasureTime("tree", [&]() { std::istringstream is(transcript); return ParseFS(is).Size(); }, 1);
+	MeasureTime("flat", [&]() { std::istringstream is(transcript); return ParseFlatFS(is).Size(FlatFS::ROOT); }, 1);
+#elif 0
+	// 1000 questions on the same tree: a walk of the tree each vs the size index
+	const std::string transcript = MakeSynthetic(1'000'000, 1000);
+	std::istringstream is(transcript);
+	const FlatFS fs = ParseFlatFS(is);
+	std::vector<long long> thresholds;
+	for (long long t = 1; t <= 1'000'000; t += 1000)
+		thresholds.push_back(t * 1000);
+	MeasureTime("walks", [&]() {
+		long long check = 0;
+		for (const long long threshold : thresholds)
+			fs.Visit([&](FlatFS::index_t i) { if (fs.GetKind(i) == FlatFS::DIR && fs.Size(i) <= threshold) check += fs.Size(i); });
+		return check;
+	}, 1);
+	MeasureTime("index", [&]() {
+		const SizeIndex index(fs);
+		long long check = 0;
+		for (const long long sum : index.SumAtMost(thresholds))
+			check += sum;
+		return check;
+	}, 1);
+#elif 0
+	const SizeIndex index(ParseFlatFS(in));
+	std::cout << PartOne(index) << " " << PartTwo(index) << std::endl;  // 1667443 8998590
+#elif 0
+	const FlatFS fs = ParseFlatFS(in);
+	std::cout << PartOne(fs) << " " << PartTwo(fs) << std::endl;  // 1667443 8998590
+#elif 0
+	long long size = PartOne(in);
 	std::cout << size << std::endl;  // 1667443
 #else
-	int size = PartTwo(in);
+	long long size = PartTwo(in);
 	std::cout << size << std::endl;  // 8998590
 #endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
@@ -14,6 +14,14 @@
 #include <string_view>
 #include <algorithm>
 #include <functional>
+#include <cstdint>
+
+#include "..\stuffs\ThreadPool.h"
+#include "..\stuffs\BinaryInput.h"
+#include "..\stuffs\LineReader.h"
+#include "..\stuffs\Benchmark.h"
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
 
 #ifdef _DEBUG
 #include <assert.h>
@@ -24,147 +32,418 @@
 
 
 
-void Alloc(std::vector<std::vector<int>>& matrix, size_t N)
+// Heights of the trees, one byte per tree, row after row
+struct Forest
 {
-	matrix.resize(N);
-	for (size_t i = 0; i < N; ++i)
-		matrix[i].resize(N);
-}
-
-std::vector<std::vector<int>> ParseMatrix(std::istream& in)
+	size_t rows = 0;
+	size_t cols = 0;
+	std::vector<uint8_t> heights;
+
+	const uint8_t* Row(size_t ir) const { return &heights[ir * cols]; }
+};
+
+// Parses the grid straight from the text (read, or mapped): lines have all the same length,
+// so row ir starts at ir * stride and rows are parsed in parallel. A row is a plain loop
+// subtracting '0', that the compiler vectorizes.
+// A forest that is not rectangular (or not of digits) gives an empty forest
+Forest ParseForest(ThreadPool& pool, std::string_view text)
 {
-	std::vector<std::vector<int>> matrix;
+	TRACE_SCOPE("parse", "day08");
 
-	size_t ir = 0;
-	for (std::string line; std::getline(in, line); ++ir)
+	Forest forest;
+	forest.cols = std::min(text.find_first_of("\r\n"), text.size());
+	if (forest.cols == 0)
+		return forest;
+
+	const std::string_view eol = text.substr(forest.cols, (forest.cols < text.size() && text[forest.cols] == '\r') ? 2 : 1);
+	const size_t stride = forest.cols + eol.size();
+
+	// up to the end, or to a blank line: every line ends where the first one does
+	for (size_t pos = 0; pos < text.size() && text[pos] != '\r' && text[pos] != '\n'; pos += stride)
 	{
-		if (line.empty())
-			break;
+		const size_t end = pos + forest.cols;
+		const std::string_view tail = text.substr(std::min(end, text.size()), eol.size());  // the last line may end the text
+		if (end > text.size() || tail != eol.substr(0, tail.size()))
+			return Forest();
+		++forest.rows;
+	}
 
-		if (ir == 0)
+	forest.heights.resize(forest.rows * forest.cols);
+	std::vector<uint8_t> bad(forest.rows, 0);  // a line of the right length, but not of digits
+	ParallelFor(pool, 0, forest.rows, [&](size_t ir) {
+		const char* line = text.data() + ir * stride;
+		uint8_t* row = &forest.heights[ir * forest.cols];
+		uint8_t not_digit = 0;
+		for (size_t ic = 0; ic < forest.cols; ++ic)
 		{
-			ASSERT(matrix.empty());
-			Alloc(matrix, line.size());
+			row[ic] = (uint8_t)(line[ic] - '0');
+			not_digit |= (uint8_t)(row[ic] > 9);
 		}
-		else
-			ASSERT(!matrix.empty() && matrix.size() == line.size());
+		bad[ir] = not_digit;
+	});
 
-		for (size_t ic = 0; ic < line.size(); ++ic)
-			matrix[ir][ic] = line[ic] - '0';
-	}
-
-	return std::move(matrix);
+	if (std::find(bad.begin(), bad.end(), 1) != bad.end())
+		return Forest();
+	return forest;
 }
 
-bool Visible(const std::vector<std::vector<int>>& matrix, const size_t ir, const size_t ic)
-{
-	ASSERT(0 <= ir && ir < matrix.size());
-	ASSERT(0 <= ic && ic < matrix[ir].size());
-
-	{
-		size_t _ir;
-
-		for (_ir = 0; _ir < ir; ++_ir)
-			if (matrix[_ir][ic] >= matrix[ir][ic])
-				break;
-		if (_ir >= ir)
-			return true;
-
-		for (_ir = ir + 1; _ir < matrix.size(); ++_ir)
-			if (matrix[_ir][ic] >= matrix[ir][ic])
-				break;
-		if (_ir >= matrix.size())
-			return true;
-	}
+// The forest is solved in tiles of TILE x TILE trees, the parallel tasks: the working set of
+// a task stays small, whatever the shape of the forest. A first pass over the tiles records
+// what the trees outside a tile show to it, per column of every band of TILE rows and per
+// row of every strip of TILE columns (well below a byte per tree): then the tiles are independent
+const size_t TILE = 256;
 
+// Inclusive scan of 'count' slices of 'size' elements, in place: forward (slice i merges
+// slice i-1) or backward (slice i merges slice i+1)
+template <typename T, typename TMerge>
+void ScanSlices(std::vector<T>& v, size_t count, size_t size, bool forward, TMerge merge)
+{
+	for (size_t n = 1; n < count; ++n)
 	{
-		size_t _ic;
-
-		for (_ic = 0; _ic < ic; ++_ic)
-			if (matrix[ir][_ic] >= matrix[ir][ic])
-				break;
-		if (_ic >= ic)
-			return true;
-
-		for (_ic = ic + 1; _ic < matrix[ir].size(); ++_ic)
-			if (matrix[ir][_ic] >= matrix[ir][ic])
-				break;
-		if (_ic >= matrix[ir].size())
-			return true;
+		const size_t i = forward ? n : count - 1 - n;
+		const size_t j = forward ? i - 1 : i + 1;
+		for (size_t e = 0; e < size; ++e)
+			v[i * size + e] = merge(v[i * size + e], v[j * size + e]);
 	}
-
-	return false;
 }
 
-int PartOne(std::istream& in)
+// Trees visible from outside, in O(n) for n trees: four sweeps, each keeping the tallest
+// tree met so far along its rows (or columns). A tree taller than that is visible.
+// The sweeps of a tile start from the tallest trees of the tiles above (below, on the left,
+// on the right)
+int PartOne(const Forest& forest, ThreadPool& pool)
 {
-	std::vector<std::vector<int>> matrix = std::move(ParseMatrix(in));
-
-	int count = 0;
-	for (size_t ir = 0; ir < matrix.size(); ++ir)
-		for (size_t ic = 0; ic < matrix[ir].size(); ++ic)
-			if (Visible(matrix, ir, ic))
-				++count;
-
-	return count;
+	const size_t rows = forest.rows;
+	const size_t cols = forest.cols;
+	if (rows == 0)
+		return 0;
+
+	const size_t bands = (rows + TILE - 1) / TILE;
+	const size_t strips = (cols + TILE - 1) / TILE;
+
+	// tallest tree of every column of every band, of every row of every strip
+	std::vector<int8_t> column_top(bands * cols, -1);
+	std::vector<int8_t> row_left(strips * rows, -1);
+	ParallelFor(pool, 0, bands * strips, [&](size_t i) {
+		const size_t b = i / strips, t = i % strips;
+		const size_t cbegin = t * TILE, cend = std::min(cbegin + TILE, cols);
+		for (size_t ir = b * TILE; ir < std::min(b * TILE + TILE, rows); ++ir)
+		{
+			const uint8_t* row = forest.Row(ir);
+			int8_t* top = &column_top[b * cols];
+			int8_t tallest = -1;
+			for (size_t ic = cbegin; ic < cend; ++ic)
+			{
+				top[ic] = std::max(top[ic], (int8_t)row[ic]);
+				tallest = std::max(tallest, (int8_t)row[ic]);
+			}
+			row_left[t * rows + ir] = tallest;
+		}
+	});
+
+	// then merged with the bands above (below), the strips on the left (right)
+	auto tallest = [](int8_t l, int8_t r) { return std::max(l, r); };
+	std::vector<int8_t> column_bottom = column_top;
+	std::vector<int8_t> row_right = row_left;
+	ScanSlices(column_top, bands, cols, true, tallest);
+	ScanSlices(column_bottom, bands, cols, false, tallest);
+	ScanSlices(row_left, strips, rows, true, tallest);
+	ScanSlices(row_right, strips, rows, false, tallest);
+
+	return ParallelReduce(pool, 0, bands * strips, 0
+		, [&](size_t i) {
+			const size_t b = i / strips, t = i % strips;
+			const size_t rbegin = b * TILE, rend = std::min(rbegin + TILE, rows);
+			const size_t cbegin = t * TILE, cend = std::min(cbegin + TILE, cols);
+			const size_t width = cend - cbegin;
+			std::vector<uint8_t> visible((rend - rbegin) * width, 0);  // 1: the tree is visible
+
+			// from left and from right
+			for (size_t ir = rbegin; ir < rend; ++ir)
+			{
+				const uint8_t* row = forest.Row(ir);
+				uint8_t* vis = &visible[(ir - rbegin) * width];
+				int tallest = (t > 0) ? row_left[(t - 1) * rows + ir] : -1;
+				for (size_t ic = cbegin; ic < cend && tallest < 9; ++ic)
+					if (row[ic] > tallest)
+					{
+						vis[ic - cbegin] = 1;
+						tallest = row[ic];
+					}
+
+				tallest = (t + 1 < strips) ? row_right[(t + 1) * rows + ir] : -1;
+				for (size_t ic = cend; ic-- > cbegin && tallest < 9; )
+					if (row[ic] > tallest)
+					{
+						vis[ic - cbegin] = 1;
+						tallest = row[ic];
+					}
+			}
+
+			// from top and from bottom: a whole row of the tile at a time, one running maximum
+			// per column (no branches, the inner loop vectorizes)
+			int8_t tallest[TILE];
+			auto sweep = [&](size_t ir) {
+				const uint8_t* row = forest.Row(ir) + cbegin;
+				uint8_t* vis = &visible[(ir - rbegin) * width];
+				for (size_t ic = 0; ic < width; ++ic)
+				{
+					vis[ic] |= (uint8_t)((int8_t)row[ic] > tallest[ic]);
+					tallest[ic] = std::max(tallest[ic], (int8_t)row[ic]);
+				}
+			};
+
+			if (b > 0)
+				std::copy_n(&column_top[(b - 1) * cols + cbegin], width, tallest);
+			else
+				std::fill_n(tallest, width, -1);
+			for (size_t ir = rbegin; ir < rend; ++ir)
+				sweep(ir);
+
+			if (b + 1 < bands)
+				std::copy_n(&column_bottom[(b + 1) * cols + cbegin], width, tallest);
+			else
+				std::fill_n(tallest, width, -1);
+			for (size_t ir = rend; ir-- > rbegin; )
+				sweep(ir);
+
+			return (int)std::count(visible.begin(), visible.end(), 1);
+		}
+		, [](int l, int r) { return l + r; }
+	);
 }
 
-int ScenicScore(const std::vector<std::vector<int>>& matrix, const size_t ir, const size_t ic)
+int PartOne(std::istream& in, size_t num_threads = 0)
 {
-	ASSERT(0 <= ir && ir < matrix.size());
-	ASSERT(0 <= ic && ic < matrix[ir].size());
-
-	int cnt, i, scenic_score = 1;
+	TRACE_SCOPE("part one", "day08");
 
-	for (cnt = 0, i = 1; ir >= i; ++i)
-	{
-		++cnt;
-		if (matrix[ir][ic] <= matrix[ir - i][ic])
-			break;
-	}
-	scenic_score *= cnt;
+	const std::string text = ReadAll(in);
+	ThreadPool pool(num_threads);
+	return PartOne(ParseForest(pool, text), pool);
+}
 
-	for (cnt = 0, i = 1; ir+i < matrix.size(); ++i)
-	{
-		++cnt;
-		if (matrix[ir][ic] <= matrix[ir+i][ic])
-			break;
-	}
-	scenic_score *= cnt;
+// Best scenic score in O(n) for n trees. Heights are 0-9: every sweep keeps, for each height h,
+// the position of the last tree at least h tall, that blocks the view of a tree of height h.
+// The viewing distance of every tree is then a lookup.
+// The sweeps of a tile start from the tables of the tiles above (below, on the left, on the
+// right): for each column (row) and height, the last (first) row (column) at least that tall
+long long PartTwo(const Forest& forest, ThreadPool& pool)
+{
+	const size_t rows = forest.rows;
+	const size_t cols = forest.cols;
+	if (rows == 0)
+		return 0;
+
+	const size_t bands = (rows + TILE - 1) / TILE;
+	const size_t strips = (cols + TILE - 1) / TILE;
+
+	// tables [band][h][column] and [strip][row][h] of every tile, then merged with those of the
+	// tiles above (below, on the left, on the right): the last is the latest, the first is the
+	// earliest. The edges block everything
+	std::vector<uint32_t> column_last(bands * 10 * cols, 0);
+	std::vector<uint32_t> column_first(bands * 10 * cols, (uint32_t)rows - 1);
+	std::vector<uint32_t> row_last(strips * rows * 10, 0);
+	std::vector<uint32_t> row_first(strips * rows * 10, (uint32_t)cols - 1);
+
+	ParallelFor(pool, 0, bands * strips, [&](size_t i) {
+		const size_t b = i / strips, t = i % strips;
+		const uint32_t rbegin = (uint32_t)(b * TILE), rend = (uint32_t)std::min(b * TILE + TILE, rows);
+		const uint32_t cbegin = (uint32_t)(t * TILE), cend = (uint32_t)std::min(t * TILE + TILE, cols);
+
+		// walking from the far end, the k-th height is set by the first tree at least k tall:
+		// the walk stops at the first 9 (a few trees, on real forests)
+		uint32_t* last = &column_last[b * 10 * cols];
+		uint32_t* first = &column_first[b * 10 * cols];
+		uint8_t filled_last[TILE] = {}, filled_first[TILE] = {};  // heights set, per column
+		for (uint32_t ir = rend, done = 0; ir-- > rbegin && done < cend - cbegin; )
+		{
+			const uint8_t* row = forest.Row(ir);
+			for (uint32_t ic = cbegin; ic < cend; ++ic)
+			{
+				uint8_t& filled = filled_last[ic - cbegin];
+				if (filled < 10 && filled <= row[ic])
+				{
+					for (; filled <= row[ic]; ++filled)
+						last[filled * cols + ic] = ir;
+					done += (filled == 10);
+				}
+			}
+		}
+		for (uint32_t ir = rbegin, done = 0; ir < rend && done < cend - cbegin; ++ir)
+		{
+			const uint8_t* row = forest.Row(ir);
+			for (uint32_t ic = cbegin; ic < cend; ++ic)
+			{
+				uint8_t& filled = filled_first[ic - cbegin];
+				if (filled < 10 && filled <= row[ic])
+				{
+					for (; filled <= row[ic]; ++filled)
+						first[filled * cols + ic] = ir;
+					done += (filled == 10);
+				}
+			}
+		}
 
-	for (cnt = 0, i = 1; ic >= i; ++i)
-	{
-		++cnt;
-		if (matrix[ir][ic] <= matrix[ir][ic-i])
-			break;
-	}
-	scenic_score *= cnt;
+		for (uint32_t ir = rbegin; ir < rend; ++ir)
+		{
+			const uint8_t* row = forest.Row(ir);
+			uint32_t* last = &row_last[(t * rows + ir) * 10];
+			uint32_t filled = 0;
+			for (uint32_t ic = cend; ic-- > cbegin && filled < 10; )
+				for (; filled <= row[ic]; ++filled)
+					last[filled] = ic;
+
+			uint32_t* first = &row_first[(t * rows + ir) * 10];
+			filled = 0;
+			for (uint32_t ic = cbegin; ic < cend && filled < 10; ++ic)
+				for (; filled <= row[ic]; ++filled)
+					first[filled] = ic;
+		}
+	});
+
+	auto latest = [](uint32_t l, uint32_t r) { return std::max(l, r); };
+	auto earliest = [](uint32_t l, uint32_t r) { return std::min(l, r); };
+	ScanSlices(column_last, bands, 10 * cols, true, latest);
+	ScanSlices(column_first, bands, 10 * cols, false, earliest);
+	ScanSlices(row_last, strips, 10 * rows, true, latest);
+	ScanSlices(row_first, strips, 10 * rows, false, earliest);
+
+	// a whole row of the tile at a time, no branches, the inner loops vectorize
+	auto update = [](uint32_t* blocker, size_t stride, const uint8_t* row, size_t width, uint32_t ir) {
+		for (int k = 0; k < 10; ++k)
+			for (size_t ic = 0; ic < width; ++ic)
+				blocker[k * stride + ic] = (k <= row[ic]) ? ir : blocker[k * stride + ic];
+	};
+
+	return ParallelReduce(pool, 0, bands * strips, 0LL
+		, [&](size_t i) {
+			const size_t b = i / strips, t = i % strips;
+			const uint32_t rbegin = (uint32_t)(b * TILE), rend = (uint32_t)std::min(b * TILE + TILE, rows);
+			const uint32_t cbegin = (uint32_t)(t * TILE), cend = (uint32_t)std::min(t * TILE + TILE, cols);
+			const size_t width = cend - cbegin;
+
+			// product of the distances along the row (beyond 32 bits past 2^17 columns)
+			std::vector<uint64_t> left_right((rend - rbegin) * width);
+			for (uint32_t ir = rbegin; ir < rend; ++ir)
+			{
+				const uint8_t* row = forest.Row(ir);
+				uint64_t* lr = &left_right[(ir - rbegin) * width];
+
+				uint32_t blocker[10] = {};  // from the left
+				if (t > 0)
+					std::copy_n(&row_last[((t - 1) * rows + ir) * 10], 10, blocker);
+				for (uint32_t ic = cbegin; ic < cend; ++ic)
+				{
+					const int h = row[ic];
+					lr[ic - cbegin] = ic - blocker[h];
+					for (int k = 0; k <= h; ++k)
+						blocker[k] = ic;
+				}
+
+				if (t + 1 < strips)  // from the right
+					std::copy_n(&row_first[((t + 1) * rows + ir) * 10], 10, blocker);
+				else
+					std::fill(std::begin(blocker), std::end(blocker), (uint32_t)cols - 1);
+				for (uint32_t ic = cend; ic-- > cbegin; )
+				{
+					const int h = row[ic];
+					lr[ic - cbegin] *= blocker[h] - ic;
+					for (int k = 0; k <= h; ++k)
+						blocker[k] = ic;
+				}
+			}
+
+			// looking down, then looking up and scoring
+			std::vector<uint32_t> down((rend - rbegin) * width);
+			uint32_t blocker[10 * TILE];
+
+			for (int k = 0; k < 10; ++k)
+			{
+				if (b + 1 < bands)
+					std::copy_n(&column_first[((b + 1) * 10 + k) * cols + cbegin], width, &blocker[k * TILE]);
+				else
+					std::fill_n(&blocker[k * TILE], width, (uint32_t)rows - 1);
+			}
+			for (uint32_t ir = rend; ir-- > rbegin; )
+			{
+				const uint8_t* row = forest.Row(ir) + cbegin;
+				uint32_t* dn = &down[(ir - rbegin) * width];
+				for (size_t ic = 0; ic < width; ++ic)
+					dn[ic] = blocker[row[ic] * TILE + ic] - ir;
+				update(blocker, TILE, row, width, ir);
+			}
+
+			for (int k = 0; k < 10; ++k)
+			{
+				if (b > 0)
+					std::copy_n(&column_last[((b - 1) * 10 + k) * cols + cbegin], width, &blocker[k * TILE]);
+				else
+					std::fill_n(&blocker[k * TILE], width, 0);
+			}
+			long long best = 0;
+			for (uint32_t ir = rbegin; ir < rend; ++ir)
+			{
+				const uint8_t* row = forest.Row(ir) + cbegin;
+				const uint64_t* lr = &left_right[(ir - rbegin) * width];
+				const uint32_t* dn = &down[(ir - rbegin) * width];
+				for (size_t ic = 0; ic < width; ++ic)
+				{
+					const long long score = (long long)(lr[ic] * (ir - blocker[row[ic] * TILE + ic]) * dn[ic]);
+					best = std::max(best, score);
+				}
+				update(blocker, TILE, row, width, ir);
+			}
+			return best;
+		}
+		, [](long long l, long long r) { return std::max(l, r); }
+	);
+}
 
-	for (cnt = 0, i = 1; ic+i < matrix[ir].size(); ++i)
-	{
-		++cnt;
-		if (matrix[ir][ic] <= matrix[ir][ic+i])
-			break;
-	}
-	scenic_score *= cnt;
+long long PartTwo(std::istream& in, size_t num_threads = 0)
+{
+	TRACE_SCOPE("part two", "day08");
 
-	return scenic_score;
+	const std::string text = ReadAll(in);
+	ThreadPool pool(num_threads);
+	return PartTwo(ParseForest(pool, text), pool);
 }
 
-int PartTwo(std::istream& in)
+// Best scenic score walking from every tree, for checks
+long long NaiveScenicScore(const Forest& forest)
 {
-	std::vector<std::vector<int>> matrix = std::move(ParseMatrix(in));
-
-	int best_score = 0;
-	for (size_t ir = 1; ir < matrix.size()-1; ++ir)
-		for (size_t ic = 1; ic < matrix[ir].size() - 1; ++ic)
+	long long best = 0;
+	for (size_t ir = 0; ir < forest.rows; ++ir)
+		for (size_t ic = 0; ic < forest.cols; ++ic)
 		{
-			int score = ScenicScore(matrix, ir, ic);
-			if (best_score < score)
-				best_score = score;
+			const uint8_t h = forest.Row(ir)[ic];
+			auto distance = [&](int dr, int dc) {
+				long long d = 0;
+				for (size_t r = ir + dr, c = ic + dc; r < forest.rows && c < forest.cols; r += dr, c += dc)  // wraps around at -1
+				{
+					++d;
+					if (forest.Row(r)[c] >= h)
+						break;
+				}
+				return d;
+			};
+			best = std::max(best, distance(0, -1) * distance(0, +1) * distance(-1, 0) * distance(+1, 0));
 		}
+	return best;
+}
 
-	return best_score;
+// Synthetic forest of random heights, for scale tests
+std::string MakeSynthetic(size_t rows, size_t cols, uint64_t seed = 1)
+{
+	SyntheticRng rng(seed);
+	std::string forest;
+	forest.reserve(rows * (cols + 1));
+	for (size_t ir = 0; ir < rows; ++ir)
+	{
+		for (size_t ic = 0; ic < cols; ++ic)
+			forest += (char)('0' + rng.Below(10));
+		forest += '\n';
+	}
+	return forest;
 }
 
 int main()
@@ -181,10 +460,43 @@ R"(30373
 #endif
 
 #if 0
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) { return PartTwo(in, 1); });
+#elif 0
+	// scaling of the parallel rows from 1 to N cores
+	MeasureScaling(in, [](std::istream& in, size_t num_threads) { return PartOne(in, num_threads); });
+	MeasureScaling(in, [](std::istream& in, size_t num_threads) { return PartTwo(in, num_threads); });
+#elif 0
+	// 10^4 x 10^4 synthetic forest
+	std::istringstream forest(MakeSynthetic(10'000, 10'000));
+	MeasureScaling(forest, [](std::istream& in, size_t num_threads) { return PartOne(in, num_threads); });
+	MeasureScaling(forest, [](std::istream& in, size_t num_threads) { return PartTwo(in, num_threads); });
+#elif 0
+	// against the naive walks: synthetic forests, and a wide one scoring beyond 32 bits
+	const std::string zeros = std::string(140001, '0') + '\n';
+	std::string wide = zeros + zeros + zeros;
+	wide[zeros.size() + 70000] = '5';  // 70000 * 70000 * 1 * 1
+	ThreadPool pool;
+	for (const std::string& text : { MakeSynthetic(97, 613), MakeSynthetic(613, 97), MakeSynthetic(257, 260, 7), wide })
+	{
+		const Forest forest = ParseForest(pool, text);
+		std::cout << forest.rows << "x" << forest.cols << ": " << PartTwo(forest, pool) << " " << NaiveScenicScore(forest) << std::endl;
+	}
+#elif 0
+	// mapped forest, of any size: parsed in place
+	MappedFile file;
+	if (!file.Open("input1.txt"))
+		return 1;
+	ThreadPool pool;
+	const Forest forest = ParseForest(pool, std::string_view(file.Data(), file.Size()));
+	std::cout << PartOne(forest, pool) << " " << PartTwo(forest, pool) << std::endl;  // 1798 259308
+#elif 0
 	int count = PartOne(in);
 	std::cout << count << std::endl;  // 1798
 #else
-	int count = PartTwo(in);
-	std::cout << count << std::endl;  // 259308
+	long long score = PartTwo(in);
+	std::cout << score << std::endl;  // 259308
 #endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
@@ -17,6 +17,9 @@
 #include <map>
 #include <set>
 
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
+
 #ifdef _DEBUG
 #include <assert.h>
 #define ASSERT(x)   assert(x)
@@ -102,8 +105,19 @@ int PartCommon(std::istream& in, int len)
 	return (int)visited.size();
 }
 
-int PartOne(std::istream& in) { return PartCommon(in, 1); }
-int PartTwo(std::istream& in) { return PartCommon(in, 9); }
+int PartOne(std::istream& in)
+{
+	TRACE_SCOPE("part one", "day09");
+
+	return PartCommon(in, 1);
+}
+
+int PartTwo(std::istream& in)
+{
+	TRACE_SCOPE("part two", "day09");
+
+	return PartCommon(in, 9);
+}
 
 int main()
 {
@@ -132,10 +146,15 @@ U 20)");
 #endif
 
 #if 0
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) { return PartTwo(in); });
+#elif 0
 	int count = PartOne(in);
 	std::cout << count << std::endl;  // 6384
 #else
 	int count = PartTwo(in);
 	std::cout << count << std::endl;  // 2734
 #endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
@@ -17,7 +17,9 @@
 #include <map>
 #include <set>
 
-#include "..\stuffs\Splitter.h"
+#include "..\stuffs\LineReader.h"
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
 
 #ifdef _DEBUG
 #include <assert.h>
@@ -31,28 +33,24 @@
 class CPU
 {
 public:
-	CPU()
+	constexpr CPU()
 		: x(1)
 		, cycle_cnt(1)
 	{
 	}
 
-	void Exec(const std::string& line)
+	constexpr void Exec(std::string_view line)
 	{
-		auto sline = split(line, " ");
-		ASSERT(sline.size() >= 1);
-
-		if (sline[0] == "addx")
+		if (line.starts_with("addx "))
 		{
-			ASSERT(sline.size() == 2);
-			int op = std::atoi(sline[1].c_str());
+			line.remove_prefix(5);
+			int op = ParseInt(line);
 
 			CycleStep(+2);
 			x += op;
 		}
-		else if (sline[0] == "noop")
+		else if (line == "noop")
 		{
-			ASSERT(sline.size() == 1);
 			CycleStep(+1);
 		}
 		else
@@ -60,7 +58,7 @@ public:
 	}
 
 protected:
-	virtual void CycleStep(int cycles) = 0;
+	constexpr virtual void CycleStep(int cycles) = 0;
 
 	int x;
 	int cycle_cnt;
@@ -69,7 +67,7 @@ protected:
 class CPU_1 : public CPU
 {
 public:
-	CPU_1()
+	constexpr CPU_1()
 		: CPU()
 		, milestones { 20, 60, 100, 140, 180, 220, INT_MAX }
 		, curr_milestone(0)
@@ -77,10 +75,10 @@ public:
 	{
 	}
 
-	int TotalStrengths() const { return total_strengths;}
+	constexpr int TotalStrengths() const { return total_strengths;}
 
 private:
-	virtual void CycleStep(int cycles) override
+	constexpr virtual void CycleStep(int cycles) override
 	{
 		ASSERT(cycle_cnt <= milestones[curr_milestone]);
 		cycle_cnt += cycles;
@@ -100,6 +98,8 @@ private:
 
 int PartOne(std::istream& in)
 {
+	TRACE_SCOPE("part one", "day10");
+
 	CPU_1 cpu;
 	for (std::string line; std::getline(in, line);)
 	{
@@ -112,15 +112,15 @@ int PartOne(std::istream& in)
 class CPU_2 : public CPU
 {
 public:
-	CPU_2()
+	constexpr CPU_2()
 		: CPU()
 	{
 	}
 
-	const std::string& CRT() const { return sCRT; }
+	constexpr const std::string& CRT() const { return sCRT; }
 
 private:
-	virtual void CycleStep(int cycles) override
+	constexpr virtual void CycleStep(int cycles) override
 	{
 		for (; cycles > 0; --cycles, ++cycle_cnt)
 		{
@@ -134,6 +134,8 @@ private:
 
 std::string PartTwo(std::istream& in)
 {
+	TRACE_SCOPE("part two", "day10");
+
 	CPU_2 cpu;
 	for (std::string line; std::getline(in, line);)
 	{
@@ -143,10 +145,23 @@ std::string PartTwo(std::istream& in)
 	return cpu.CRT();
 }
 
-int main()
+// Whole program in memory
+constexpr int PartOne(std::string_view program)
 {
-#if 0
-	std::istringstream in(
+	CPU_1 cpu;
+	ForEachLine(program, [&](std::string_view line) { cpu.Exec(line); });
+	return cpu.TotalStrengths();
+}
+
+constexpr std::string PartTwo(std::string_view program)
+{
+	CPU_2 cpu;
+	ForEachLine(program, [&](std::string_view line) { cpu.Exec(line); });
+	return cpu.CRT();
+}
+
+// sample of the puzzle, solved at compile time
+constexpr std::string_view SAMPLE =
 R"(addx 15
 addx -11
 addx 6
@@ -292,12 +307,29 @@ addx -6
 addx -11
 noop
 noop
-noop)");
+noop)";
+
+static_assert(PartOne(SAMPLE) == 13140);
+static_assert(PartTwo(SAMPLE) ==
+	"##..##..##..##..##..##..##..##..##..##.."
+	"###...###...###...###...###...###...###."
+	"####....####....####....####....####...."
+	"#####.....#####.....#####.....#####....."
+	"######......######......######......####"
+	"#######.......#######.......#######.....");
+
+int main()
+{
+#if 0
+	std::istringstream in{std::string(SAMPLE)};
 #else
 	std::ifstream in("input1.txt");
 #endif
 
 #if 0
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) { return PartTwo(in); });
+#elif 0
 	int total_strengths = PartOne(in);  // 14540
 	std::cout << total_strengths << std::endl;
 #else
@@ -312,4 +344,6 @@ noop)");
 	// EHZFZHCZ
 #endif
 
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
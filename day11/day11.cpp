@@ -18,6 +18,9 @@
 #include <set>
 
 #include "..\stuffs\Splitter.h"
+#include "..\stuffs\CycleDetector.h"
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
 
 #ifdef _DEBUG
 #include <assert.h>
@@ -48,11 +51,6 @@ struct Operand
 
 class Monkey
 {
-public:
-	static std::vector<Monkey> monkeys;
-	static long long worry_divider;
-	static long long worry_mod;
-
 public:
 	Monkey(int _id, const std::vector<long long>& _items, char _op_operator, const Operand& _op_operand, int _divisible_by, int _thow_true, int _thow_false)
 		: id(_id)
@@ -60,30 +58,22 @@ public:
 		, op_operator(_op_operator), op_operand(_op_operand)
 		, divisible_by(_divisible_by)
 		, thow_true(_thow_true), thow_false(_thow_false)
-		, inspection_cnt(0)
 	{
 	}
 
-	void Turn()
+	// Inspects a single item, returns the monkey it is thrown to
+	int Inspect(long long& item, long long worry_divider, long long worry_mod) const
 	{
-		while (items.size() > 0)
-		{
-			++inspection_cnt;
-
-			long long item = items.front();
-			items.erase(items.begin());
-
-			item = DoOperation(item);
-			item /= worry_divider;
-			item %= worry_mod;
-			monkeys[item % divisible_by == 0 ? thow_true : thow_false].items.push_back(item);
-		}
+		item = DoOperation(item);
+		item /= worry_divider;
+		item %= worry_mod;
+		return item % divisible_by == 0 ? thow_true : thow_false;
 	}
 
-	long InspectionCounter() const { return inspection_cnt; }
+	const std::vector<long long>& Items() const { return items; }
 
 protected:
-	long long DoOperation(long long item)
+	long long DoOperation(long long item) const
 	{
 		long long value = (op_operand.type == OperandType::Old ? item : op_operand.value);
 		switch (op_operator)
@@ -105,13 +95,15 @@ protected:
 	const int divisible_by;
 	const int thow_true;
 	const int thow_false;
-
-	long inspection_cnt;
 };
 
-std::vector<Monkey> Monkey::monkeys;
-long long Monkey::worry_divider = 3;
-long long Monkey::worry_mod = 1;
+// All the monkeys of an input, with the rules that keep worry levels manageable
+struct Troop
+{
+	std::vector<Monkey> monkeys;
+	long long worry_divider = 3;
+	long long worry_mod = 1;  // product of the divisors of the tests
+};
 
 bool ParseMonkey(std::istream& in, int& id, std::vector<long long>& items, char& op_operator, Operand& op_operand, int& divisible_by, int& thow_true, int& thow_false)
 {
@@ -199,52 +191,105 @@ bool ParseMonkey(std::istream& in, int& id, std::vector<long long>& items, char&
 	return true;
 }
 
-void ParseMonkeys(std::istream& in)
+void ParseMonkeys(std::istream& in, Troop& troop)
 {
-	Monkey::monkeys.clear();
+	TRACE_SCOPE("parse", "day11");
+
+	troop.monkeys.clear();
+	troop.worry_mod = 1;
 	while (true)
 	{
 		int id; std::vector<long long> items; char op_operator;  Operand op_operand; int divisible_by; int thow_true, thow_false;
 		if (!ParseMonkey(in, id, items, op_operator, op_operand, divisible_by, thow_true, thow_false))
 			break;
 
-		Monkey::monkeys.push_back(Monkey(id, items, op_operator, op_operand, divisible_by, thow_true, thow_false));
-		Monkey::worry_mod *= divisible_by;
+		troop.monkeys.push_back(Monkey(id, items, op_operator, op_operand, divisible_by, thow_true, thow_false));
+		troop.worry_mod *= divisible_by;
 	}
 }
 
-long long PartCommon(std::istream& in, int TURNS)
+// Follows a single item for a whole round (an item thrown to a following monkey is inspected again in the same round)
+void ItemRound(const Troop& troop, int& monkey, long long& item, std::vector<long long>& inspections)
 {
-	ParseMonkeys(in);
-
-	for (int turn = 0; turn < TURNS; ++turn)
+	while (true)
 	{
-		for (auto it = Monkey::monkeys.begin(); it != Monkey::monkeys.end(); ++it)
+		++inspections[monkey];
+		const int next = troop.monkeys[monkey].Inspect(item, troop.worry_divider, troop.worry_mod);
+		const bool same_round = next > monkey;
+		monkey = next;
+		if (!same_round)
+			break;
+	}
+}
+
+long long PartCommon(std::istream& in, int TURNS, long long worry_divider)
+{
+	Troop troop;
+	ParseMonkeys(in, troop);
+	troop.worry_divider = worry_divider;
+
+	const size_t num_monkeys = troop.monkeys.size();
+
+	// Items never interact: follow each one on its own until its (monkey, worry) state cycles, then extrapolate
+	std::vector<long long> inspections(num_monkeys, 0);
+	for (int m = 0; m < (int)num_monkeys; ++m)
+		for (const auto start_item : troop.monkeys[m].Items())
 		{
-			it->Turn();
+			CycleDetector<std::pair<int, long long>, std::vector<long long>> detector;
+
+			int monkey = m;
+			long long item = start_item;
+			std::vector<long long> counts(num_monkeys, 0);
+
+			int turn;
+			for (turn = 0; turn < TURNS && !detector.Add(std::make_pair(monkey, item), counts); ++turn)
+				ItemRound(troop, monkey, item, counts);
+
+			if (turn < TURNS)
+			{
+				size_t full_cycles;
+				const auto& base   = detector.Value(detector.CycleStep(TURNS, full_cycles));
+				const auto& first  = detector.Value(detector.Mu());
+				const auto& second = detector.Value(detector.Mu() + detector.Lambda());
+				for (size_t i = 0; i < num_monkeys; ++i)
+					counts[i] = base[i] + (long long)full_cycles * (second[i] - first[i]);
+			}
+
+			for (size_t i = 0; i < num_monkeys; ++i)
+				inspections[i] += counts[i];
 		}
-	}
 
-	int max1 = -1, max2 = -1;
-	for (auto it = Monkey::monkeys.begin(); it != Monkey::monkeys.end(); ++it)
+	long long max1 = -1, max2 = -1;
+	for (const auto cnt : inspections)
 	{
-		if (it->InspectionCounter() > max1)
+		if (cnt > max1)
 		{
 			max2 = max1;
-			max1 = it->InspectionCounter();
+			max1 = cnt;
 		}
-		else if (it->InspectionCounter() > max2)
+		else if (cnt > max2)
 		{
-			max2 = it->InspectionCounter();
+			max2 = cnt;
 		}
 	}
 	ASSERT(max1 >= 0 && max2 >= 0);
 
-	return (long long)max1 * (long long)max2;
+	return max1 * max2;
+}
+
+long long PartOne(std::istream& in)
+{
+	TRACE_SCOPE("part one", "day11");
+
+	return PartCommon(in, 20, 3);
 }
 
-long long PartOne(std::istream& in) { return PartCommon(in, 20); }
-long long PartTwo(std::istream& in) { return PartCommon(in, 10000); }
+long long PartTwo(std::istream& in)
+{
+	TRACE_SCOPE("part two", "day11");
+
+	return PartCommon(in, 10000, 1);
+}
 
 int main()
 {
@@ -283,11 +328,15 @@ Monkey 3:
 #endif
 
 #if 0
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) { return PartTwo(in); });
+#elif 0
 	long long total_strengths = PartOne(in);  // 110220
 	std::cout << total_strengths << std::endl;
 #else
-	Monkey::worry_divider = 1;
 	long long total_strengths = PartTwo(in);  // 19457438264
 	std::cout << total_strengths << std::endl;
 #endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
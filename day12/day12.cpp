@@ -17,6 +17,8 @@
 #include <map>
 #include <set>
 
+#include "..\stuffs\Trace.h"
+
 #ifdef _DEBUG
 #include <assert.h>
 #define ASSERT(x)   assert(x)
@@ -30,6 +32,8 @@ typedef std::vector<std::string> board_t;
 
 board_t ParseBoard(std::istream& in)
 {
+	TRACE_SCOPE("parse", "day12");
+
 	board_t board;
 
 	for (std::string line; std::getline(in, line);)
@@ -45,6 +49,7 @@ inline size_t RowCol2Ind(const board_t& board, size_t r, size_t c)
 inline void Ind2RowCol(const board_t& board, size_t& r, size_t& c, size_t ind ) { r = ind / board.front().size();
                                                                                   c = ind % board.front().size();}
 #include "..\stuffs\Dijkstra.h"
+#include "..\stuffs\Batch.h"
 
 void AddEgdeHelper(const board_t& board, DirectedGraph<char, int>& g, int r, int c, int dr, int dc)
 {
@@ -70,6 +75,8 @@ void PartCommon(std::istream& in, size_t& iS, size_t& iE, DirectedGraph<char, in
 {
 	board_t board = std::move(ParseBoard(in));
 
+	TRACE_SCOPE("graph build", "day12");
+
 	iS = iE = g.npos;
 	for (size_t r = 0; r < board.size(); ++r)
 	{
@@ -109,26 +116,38 @@ void PartCommon(std::istream& in, size_t& iS, size_t& iE, DirectedGraph<char, in
 
 int PartOne(std::istream& in)
 {
+	TRACE_SCOPE("part one", "day12");
+
 	size_t iS, iE;
 	DirectedGraph<char, int> g;
 	PartCommon(in, iS, iE, g);
 
 	std::vector<size_t> path;
 	std::vector<int> dist;
-	Dijkstra(g, iE, iS, path, dist);
+	{
+		TRACE_SCOPE("search", "day12");
+		Dijkstra(g, iE, iS, path, dist);
+	}
 
 	return dist[iS];
 }
 
 int PartTwo(std::istream& in)
 {
+	TRACE_SCOPE("part two", "day12");
+
 	size_t iS, iE;
 	DirectedGraph<char, int> g;
 	PartCommon(in, iS, iE, g);
 
 	std::vector<size_t> path;
 	std::vector<int> dist;
-	Dijkstra(g, iE, g.npos, path, dist);
+	{
+		TRACE_SCOPE("search", "day12");
+		Dijkstra(g, iE, g.npos, path, dist);
+	}
+
+	TRACE_SCOPE("answer", "day12");
 
 	int min_cnt = INT_MAX;
 	for (size_t iNode = 0; iNode < g.NodeCount(); ++iNode)
@@ -156,10 +175,15 @@ abdefghi)");
 #endif
 
 #if 0
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) { return PartTwo(in); });
+#elif 0
 	int pah_len = PartOne(in);  // 484
 	std::cout << pah_len  << std::endl;
 #else
 	int min_pah_len = PartTwo(in);  // 478
 	std::cout << min_pah_len << std::endl;
 #endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
@@ -17,6 +17,9 @@
 #include <map>
 #include <set>
 
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
+
 #ifdef _DEBUG
 #include <assert.h>
 #define ASSERT(x)   assert(x)
@@ -276,6 +279,8 @@ int CompareTerms(LexAnalyzer::Term tl, LexAnalyzer::Term tr)
 
 int PartOne(std::istream& in)
 {
+	TRACE_SCOPE("part one", "day13");
+
 	int index_sum = 0;
 	for (int index = 1; true; ++index)
 	{
@@ -302,6 +307,8 @@ int PartOne(std::istream& in)
 
 int PartTwo(std::istream& in)
 {
+	TRACE_SCOPE("part two", "day13");
+
 	std::vector<std::pair<std::string, LexAnalyzer::Term>> packets;
 
 	const std::string distress[2] = { "[[2]]", "[[6]]" };
@@ -362,10 +369,15 @@ R"([1,1,3,1,1]
 #endif
 
 #if 0
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) { return PartTwo(in); });
+#elif 0
 	int sum = PartOne(in);  // 5196
 	std::cout << sum << std::endl;
 #else
 	int prod = PartTwo(in);  // 22134
 	std::cout << prod << std::endl;
 #endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
@@ -18,6 +18,8 @@
 #include <set>
 
 #include "..\stuffs\Splitter.h"
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
 
 #ifdef _DEBUG
 #include <assert.h>
@@ -43,6 +45,8 @@ struct Coo
 
 void ParseField(std::istream& in, std::map<Coo, char>& field, Coo& cMin, Coo& cMax)
 {
+	TRACE_SCOPE("parse", "day14");
+
 	cMin.x = cMin.y = INT_MAX;
 	cMax.x = cMax.y = INT_MIN;
 
@@ -122,6 +126,8 @@ int DropSandCount(std::map<Coo, char>& field, const Coo& source, const int y_max
 
 int PartOne(std::istream& in)
 {
+	TRACE_SCOPE("part one", "day14");
+
 	Coo cMin, cMax;
 	std::map<Coo, char> field;
 	ParseField(in, field, cMin, cMax);
@@ -145,6 +151,8 @@ void AddFloor(std::map<Coo, char>& field, const Coo& source, const int y_floor)
 
 int PartTwo(std::istream& in)
 {
+	TRACE_SCOPE("part two", "day14");
+
 	Coo cMin, cMax;
 	std::map<Coo, char> field;
 	ParseField(in, field, cMin, cMax);
@@ -165,10 +173,15 @@ R"(498,4 -> 498,6 -> 496,6
 #endif
 
 #if 0
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) { return PartTwo(in); });
+#elif 0
 	int cnt = PartOne(in);  // 618
 	std::cout << cnt << std::endl;
 #else
 	int cnt = PartTwo(in);  // 26358
 	std::cout << cnt << std::endl;
 #endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
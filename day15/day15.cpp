@@ -16,8 +16,13 @@
 #include <functional>
 #include <map>
 #include <set>
+#include <atomic>
 
 #include "..\stuffs\Splitter.h"
+#include "..\stuffs\ThreadPool.h"
+#include "..\stuffs\Benchmark.h"
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
 
 #ifdef _DEBUG
 #include <assert.h>
@@ -91,6 +96,8 @@ struct Position
 
 void ParseField(std::istream& in, std::vector<Position>& field)
 {
+	TRACE_SCOPE("parse", "day15");
+
 	field.clear();
 	for (std::string line; std::getline(in, line); )
 	{
@@ -115,6 +122,8 @@ void ParseField(std::istream& in, std::vector<Position>& field)
 
 int PartOne(std::istream& in, const int yRow)
 {
+	TRACE_SCOPE("part one", "day15");
+
 	std::vector<Position> field;
 	ParseField(in, field);
 
@@ -203,31 +212,47 @@ void ErodeIntervals(std::vector<Interval>& intervals, const Interval& interval)
 	}
 }
 
-long long PartTwo(std::istream& in, const int order)
+// Looks for the only cell of the row not covered by any sensor
+bool FreeCell(const std::vector<Position>& field, const int yRow, const int order, int& x)
 {
-	std::vector<Position> field;
-	ParseField(in, field);
+	std::vector<Interval> intervals;
+	intervals.push_back(Interval(0, order));
 
-	for (int yRow = 0; yRow <= order; ++yRow)
+	for (const Position& p : field)
 	{
-		std::vector<Interval> intervals;
-		intervals.push_back(Interval(0, order));
+		Interval p_interval;
+		if (!p.GetInterval(yRow, p_interval.x0, p_interval.x1))
+			continue;
 
-		for (const Position& p : field)
-		{
-			Interval p_interval;
-			if (!p.GetInterval(yRow, p_interval.x0, p_interval.x1))
-				continue;
-
-			ErodeIntervals(intervals, p_interval);
-		}
+		ErodeIntervals(intervals, p_interval);
+	}
 
-		if (intervals.size() == 1 && intervals[0].x0 == intervals[0].x1)
-			return (long long)intervals[0].x0 * (long long)order + (long long)yRow;
+	if (intervals.size() == 1 && intervals[0].x0 == intervals[0].x1)
+	{
+		x = intervals[0].x0;
+		return true;
 	}
+	return false;
+}
+
+long long PartTwo(std::istream& in, const int order, size_t num_threads = 0)
+{
+	TRACE_SCOPE("part two", "day15");
 
-	ASSERT(false);
-	return -1;
+	std::vector<Position> field;
+	ParseField(in, field);
+
+	// Rows are independent: scan them in parallel, until someone finds the free cell
+	ThreadPool pool(num_threads);
+	std::atomic<long long> tuning_freq = -1;
+	ParallelFor(pool, 0, (size_t)order+1, [&](size_t yRow) {
+		int x;
+		if (tuning_freq < 0 && FreeCell(field, (int)yRow, order, x))
+			tuning_freq = (long long)x * (long long)order + (long long)yRow;
+	}, 1000);
+
+	ASSERT(tuning_freq >= 0);
+	return tuning_freq;
 }
 
 int main()
@@ -257,10 +282,18 @@ R"(2,18:-2,15
 #endif
 
 #if 0
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [order](std::istream& in) { return PartTwo(in, order, 1); });
+#elif 0
+	// scaling of the parallel scan from 1 to N cores
+	MeasureScaling(in, [order](std::istream& in, size_t num_threads) { return PartTwo(in, order, num_threads); });
+#elif 0
 	int cnt = PartOne(in, yRow);  // 5040643
 	std::cout << cnt << std::endl;
 #else
 	long long tuning_freq = PartTwo(in, order);  // 11016575214126
 	std::cout << tuning_freq << std::endl;
 #endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
@@ -19,6 +19,11 @@
 
 #include "..\stuffs\Dijkstra.h"
 #include "..\stuffs\Splitter.h"
+#include "..\stuffs\BranchAndBound.h"
+#include "..\stuffs\Benchmark.h"
+#include "..\stuffs\ResultCache.h"
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
 
 #ifdef _DEBUG
 #include <assert.h>
@@ -34,7 +39,6 @@ struct Valve
 {
 	std::string               name;
 	int                       flow_rate;
-	bool                      open;
 	std::vector<std::string>  lead_to;
 };
 
@@ -93,6 +97,8 @@ struct ReducedCave
 
 void ParseCave(std::istream& in, Cave& cave)
 {
+	TRACE_SCOPE("parse", "day16");
+
 	cave.Clear();
 	for (std::string line; std::getline(in, line); )
 	{
@@ -118,7 +124,6 @@ void ParseCave(std::istream& in, Cave& cave)
 				valve->lead_to.push_back(lead_to);
 		}
 
-		valve->open = false;
 		cave.valves.push_back(valve);
 
 		ASSERT(!cave.by_names.contains(valve->name));
@@ -150,89 +155,75 @@ void ParseCave(std::istream& in, Cave& cave)
 	}
 }
 
-int BestExtimate(const ReducedCave& reduced, int remaining)
+typedef unsigned long long valves_mask_t;  // bit i set  <==>  reduced.valves[i] is open
+
+inline bool IsOpen(valves_mask_t open, size_t i) { return (open >> i) & 1; }
+
+int BestExtimate(const ReducedCave& reduced, valves_mask_t open, int remaining)
 {
 	int total_pressure = 0;
-	for (auto it = reduced.valves.cbegin(); it != reduced.valves.cend() && remaining > 0; ++it)
+	for (size_t i = 0; i < reduced.valves.size() && remaining > 0; ++i)
 	{
-		if ((*it)->open)
+		if (IsOpen(open, i))
 			continue;
 
-		if ((*it)->flow_rate == 0)
+		if (reduced.valves[i]->flow_rate == 0)
 			break;
 
 		--remaining;  // open valve
-		total_pressure += (*it)->flow_rate * remaining;
+		total_pressure += reduced.valves[i]->flow_rate * remaining;
 		--remaining;  // go-next
 	}
 	return total_pressure;
 }
 
-void MakePerm(const ReducedCave& reduced, std::vector<size_t>& perm, size_t node_idx, int remaining)
+// Appends the states reachable moving from 'valve' and opening a closed valve, best first
+template <typename TNode, typename TMove>
+void ExpandMoves(const ReducedCave& reduced, valves_mask_t open, size_t valve, int remaining, int pressure, std::vector<TNode>& children, TMove move)
 {
-	ASSERT(reduced.valves.size() == reduced.matrix.size());
-	perm.resize(0);
-	for (size_t i = 0; i < reduced.valves.size(); ++i)
+	const size_t first = children.size();
+	for (size_t next = 0; next < reduced.valves.size(); ++next)
 	{
-		if (i == node_idx)
+		if (next == valve || IsOpen(open, next) || reduced.valves[next]->flow_rate == 0)
 			continue;
-		perm.push_back(i);
+
+		const int next_remaining = remaining - reduced.matrix[valve][next] - 1;  // go there, open valve
+		if (next_remaining <= 0)
+			continue;
+
+		children.push_back(move(next, next_remaining, pressure + next_remaining * reduced.valves[next]->flow_rate, open | (1ULL << next)));
 	}
 
 	std::sort(
-		perm.begin()
-		, perm.end()
-		, [&](size_t lnode, size_t rnode) {
-			const int l_flow = (reduced.valves[lnode]->open ? 0 : reduced.valves[lnode]->flow_rate);
-			const int r_flow = (reduced.valves[rnode]->open ? 0 : reduced.valves[rnode]->flow_rate);
-			return (remaining - reduced.matrix[node_idx][lnode]) * l_flow > (remaining - reduced.matrix[node_idx][rnode]) * r_flow;
-		}
+		  children.begin()+first
+		, children.end()
+		, [](const TNode& l, const TNode& r) { return l.pressure > r.pressure; }
 	);
 }
 
-void Visit(ReducedCave& reduced, const size_t curr_node, int remaining, int curr_pressure, int& best_pressure_ever)
+struct Search1  // you alone
 {
-	ASSERT(remaining >= 0);
-
-	if (remaining <= 1)
+	typedef int value_type;
+	struct node_type
 	{
-		if (best_pressure_ever < curr_pressure)
-			best_pressure_ever = curr_pressure;
-		return;
-	}
+		size_t         valve;
+		int            remaining;
+		int            pressure;
+		valves_mask_t  open;
+	};
 
-	Valve* curr_valve = reduced.valves[curr_node];
+	const ReducedCave& reduced;
 
-	if (curr_valve->flow_rate > 0 && !curr_valve->open)
-	{
-		curr_valve->open = true;
-		remaining -= 1;
-		curr_pressure += remaining * curr_valve->flow_rate;
-
-		if (best_pressure_ever < curr_pressure)
-			best_pressure_ever = curr_pressure;
-	}
+	value_type Value(const node_type& n) const { return n.pressure; }
+	value_type Bound(const node_type& n) const { return n.pressure + BestExtimate(reduced, n.open, n.remaining); }
 
-	std::vector<size_t> perm;
-	MakePerm(reduced, perm, curr_node, remaining);
-
-	const int best_extimate = BestExtimate(reduced, remaining);
-	for (const auto& next_node : perm)
+	void Expand(const node_type& n, std::vector<node_type>& children) const
 	{
-		if (curr_pressure + best_extimate < best_pressure_ever)
-			break;
-		if (reduced.valves[next_node]->open || reduced.valves[next_node]->flow_rate == 0)
-			break;
-		Visit(reduced, next_node, remaining - reduced.matrix[curr_node][next_node], curr_pressure, best_pressure_ever);
-	}
-
-	if (curr_valve->flow_rate > 0 && curr_valve->open)
-	{
-		curr_pressure -= remaining * curr_valve->flow_rate;
-		remaining -= 1;
-		curr_valve->open = false;
+		ExpandMoves(reduced, n.open, n.valve, n.remaining, n.pressure, children
+			, [](size_t next, int remaining, int pressure, valves_mask_t open) { return node_type{ next, remaining, pressure, open }; }
+		);
 	}
-}
+};
 
 void CaveToGraph(const Cave& cave, DirectedGraph<Valve*, int>& graph)
 {
@@ -292,178 +283,180 @@ void GraphToReduced(const Cave& cave, const DirectedGraph<Valve*, int>& graph, R
 	}
 }
 
-int PartOne(std::istream& in)
+std::string SerializeReduced(const ReducedCave& reduced)
 {
-	Cave cave;
-	ParseCave(in, cave);
-
-	ReducedCave reduced;
+	std::ostringstream os;
+	for (const Valve* valve : reduced.valves)
+		os << valve->name << ' ';
+	os << '\n';
+	for (const auto& row : reduced.matrix)
 	{
-		DirectedGraph<Valve*, int> graph;
-		CaveToGraph(cave, graph);
-
-		GraphToReduced(cave, graph, reduced);
+		for (const int dist : row)
+			os << dist << ' ';
+		os << '\n';
 	}
+	return os.str();
+}
 
-	const size_t node_AA = reduced.ValveToIndex("AA");
-	const int remaining = 30;
+bool DeserializeReduced(const std::string& text, const Cave& cave, ReducedCave& reduced)
+{
+	reduced.Clear();
 
-	ASSERT(node_AA != reduced.npos && reduced.valves[node_AA]->name == "AA");
+	std::istringstream is(text);
+	std::string line;
+	if (!std::getline(is, line))
+		return false;
+
+	std::istringstream names(line);
+	for (std::string name; names >> name; )
+	{
+		const auto it = cave.by_names.find(name);
+		if (it == cave.by_names.end())
+			return false;
+		reduced.valves.push_back(it->second);
+	}
 
-	int best_pressure_ever = 0;
-	Visit(reduced, node_AA, remaining, 0, best_pressure_ever);
+	reduced.matrix.assign(reduced.valves.size(), std::vector<int>(reduced.valves.size(), 0));
+	for (auto& row : reduced.matrix)
+		for (int& dist : row)
+			if (!(is >> dist))
+				return false;
 
-	return best_pressure_ever;
+	return true;
 }
 
-void BestExtimate2_DoStep(const ReducedCave& reduced, int& total_pressure, int& remainingNN)
+// Parses the cave and reduces it to the distance matrix between valves worth opening
+// (the matrix is taken from the cache, when available)
+void MakeReducedCave(std::istream& in, Cave& cave, ReducedCave& reduced, const ResultCache* cache)
 {
-	ASSERT(remainingNN >= 0);
+	const std::string input = ReadAll(in);
+	std::istringstream is(input);
+	ParseCave(is, cave);
 
-	for (auto it = reduced.valves.cbegin(); it != reduced.valves.cend(); ++it)
-	{
-		if ((*it)->open)
-			continue;
+	const std::string key = ResultCache::Key("day16", "reduced", "", input);
+	std::string text;
+	if (cache != nullptr && cache->Load(key, text) && DeserializeReduced(text, cave, reduced))
+		return;
 
-		if ((*it)->flow_rate == 0)
-		{
-			remainingNN = 0;
-			return;
-		}
+	{
+		TRACE_SCOPE("graph build", "day16");
+		DirectedGraph<Valve*, int> graph;
+		CaveToGraph(cave, graph);
 
-		--remainingNN;  // open valve
-		total_pressure += (*it)->flow_rate * remainingNN;
-		--remainingNN;  // go-next
-		return;
+		GraphToReduced(cave, graph, reduced);
 	}
-	ASSERT(false);
-}
-
-int BestExtimate2(const ReducedCave& reduced, int remaining0, int remaining1)
-{
-	ASSERT(remaining0 >= remaining1);
 
-	int total_pressure = 0;
-	while (remaining0 > 0 || remaining1 > 0)
-		if (remaining0 >= remaining1)
-			BestExtimate2_DoStep(reduced, total_pressure, remaining0);
-		else
-			BestExtimate2_DoStep(reduced, total_pressure, remaining1);
-	return total_pressure;
+	if (cache != nullptr)
+		cache->Store(key, SerializeReduced(reduced));
 }
 
-void Visit2(ReducedCave& reduced, const size_t curr_node0, int remaining0, const size_t curr_node1, int remaining1, int curr_pressure, int& best_pressure_ever);
+// Minutes of the two parts (also part of the cache keys of the answers)
+const int PART_ONE_MINUTES = 30;
+const int PART_TWO_MINUTES = 26;
 
-void Visit2_(ReducedCave& reduced, const size_t curr_node0, int remaining0, const size_t curr_node1, int remaining1, int curr_pressure, int& best_pressure_ever)
+int PartOne(std::istream& in, size_t num_threads = 0, const ResultCache* cache = nullptr)
 {
-	Valve* curr_valve0 = reduced.valves[curr_node0];
-	Valve* curr_valve1 = reduced.valves[curr_node1];
+	TRACE_SCOPE("part one", "day16");
 
-	ASSERT(curr_valve0->flow_rate > 0 && !curr_valve0->open);
+	Cave cave;
+	ReducedCave reduced;
+	MakeReducedCave(in, cave, reduced, cache);
 
-	curr_valve0->open = true;
-	remaining0 -= 1;
-	curr_pressure += remaining0 * curr_valve0->flow_rate;
+	const size_t node_AA = reduced.ValveToIndex("AA");
+	const int remaining = PART_ONE_MINUTES;
+
+	ASSERT(node_AA != reduced.npos && reduced.valves[node_AA]->name == "AA");
 
-	if (best_pressure_ever < curr_pressure)
-		best_pressure_ever = curr_pressure;
+	ASSERT(reduced.valves.size() <= 8*sizeof(valves_mask_t));
 
-	if (remaining0 >= remaining1)
-		Visit2(reduced, curr_node0, remaining0, curr_node1, remaining1, curr_pressure, best_pressure_ever);
-	else
-		Visit2(reduced, curr_node1, remaining1, curr_node0, remaining0, curr_pressure, best_pressure_ever);
+	ThreadPool pool(num_threads);
+	Search1 search{ reduced };
+	BranchAndBound<Search1> bnb(search, pool);
+	TRACE_SCOPE("search", "day16");
+	int best_pressure_ever = bnb.Solve(Search1::node_type{ node_AA, remaining, 0, 0 }, 0);
 
-	curr_pressure -= remaining0 * curr_valve0->flow_rate;
-	remaining0 += 1;
-	curr_valve0->open = false;
+	return best_pressure_ever;
 }
 
-void Visit2(ReducedCave& reduced, const size_t curr_node0, int remaining0, const size_t curr_node1, int remaining1, int curr_pressure, int& best_pressure_ever)
+int BestExtimate2(const ReducedCave& reduced, valves_mask_t open, int remaining0, int remaining1)
 {
-	ASSERT(remaining0 >= remaining1);
-
-	Valve* curr_valve0 = reduced.valves[curr_node0];
-	Valve* curr_valve1 = reduced.valves[curr_node1];
-
-	if (remaining0 <= 1)
+	// as BestExtimate, but the best valves go to whoever has more time left
+	int total_pressure = 0;
+	for (size_t i = 0; i < reduced.valves.size(); ++i)
 	{
-		ASSERT(remaining1 <= 1);
-		if (best_pressure_ever < curr_pressure)
-			best_pressure_ever = curr_pressure;
-		return;
-	}
+		if (IsOpen(open, i))
+			continue;
 
-	std::vector<size_t> perm;
+		if (reduced.valves[i]->flow_rate == 0)
+			break;
 
-	if (remaining0 > remaining1)
-	{
-		const int best_extimate = BestExtimate2(reduced, remaining0, remaining1);
-		MakePerm(reduced, perm, curr_node0, remaining0);
-		for (const auto& next_node0 : perm)
-		{
-			if (curr_pressure + best_extimate < best_pressure_ever)
-				break;
-			if (reduced.valves[next_node0]->open || reduced.valves[next_node0]->flow_rate == 0)
-				break;
-			const int dist = reduced.matrix[curr_node0][next_node0];
-			ASSERT(dist > 0);
-			Visit2_(reduced, next_node0, remaining0 - dist, curr_node1, remaining1, curr_pressure, best_pressure_ever);
-		}
-	}
-	else if (remaining0 == remaining1)
-	{
-		const int best_extimate = BestExtimate2(reduced, remaining0, remaining1);
-		MakePerm(reduced, perm, curr_node1, remaining1);
-		for (const auto& next_node1 : perm)
-		{
-			if (curr_pressure + best_extimate < best_pressure_ever)
-				break;
-			if (reduced.valves[next_node1]->open || reduced.valves[next_node1]->flow_rate == 0)
-				break;
-			const int dist = reduced.matrix[curr_node1][next_node1];
-			ASSERT(dist > 0);
-			Visit2_(reduced, next_node1, remaining1 - dist, curr_node0, remaining0, curr_pressure, best_pressure_ever);
-		}
-	}
-	else
-	{
-		const int best_extimate = BestExtimate2(reduced, remaining1, remaining0);
-		MakePerm(reduced, perm, curr_node1, remaining1);
-		for (const auto& next_node1 : perm)
-		{
-			if (curr_pressure + best_extimate < best_pressure_ever)
-				break;
-			if (reduced.valves[next_node1]->open || reduced.valves[next_node1]->flow_rate == 0)
-				break;
-			const int dist = reduced.matrix[curr_node1][next_node1];
-			ASSERT(dist > 0);
-			Visit2_(reduced, next_node1, remaining1 - dist, curr_node0, remaining0, curr_pressure, best_pressure_ever);
-		}
+		int& remaining = (remaining0 >= remaining1 ? remaining0 : remaining1);
+		if (remaining <= 0)
+			break;
+
+		--remaining;  // open valve
+		total_pressure += reduced.valves[i]->flow_rate * remaining;
+		--remaining;  // go-next
 	}
-	if (best_pressure_ever < curr_pressure)
-		best_pressure_ever = curr_pressure;
+	return total_pressure;
 }
 
-int PartTwo(std::istream& in)
+struct Search2  // you and the elephant
 {
-	Cave cave;
-	ParseCave(in, cave);
+	typedef int value_type;
+	struct node_type
+	{
+		size_t         valve[2];
+		int            remaining[2];  // remaining[0] >= remaining[1]: who has more time moves first
+		int            pressure;
+		valves_mask_t  open;
+	};
 
-	ReducedCave reduced;
+	const ReducedCave& reduced;
+
+	value_type Value(const node_type& n) const { return n.pressure; }
+	value_type Bound(const node_type& n) const { return n.pressure + BestExtimate2(reduced, n.open, n.remaining[0], n.remaining[1]); }
+
+	void Expand(const node_type& n, std::vector<node_type>& children) const
 	{
-		DirectedGraph<Valve*, int> graph;
-		CaveToGraph(cave, graph);
+		if (n.remaining[0] <= 1)
+			return;
 
-		GraphToReduced(cave, graph, reduced);
+		auto make_node = [&n](size_t valve0, int remaining0, int pressure, valves_mask_t open) {
+			if (remaining0 >= n.remaining[1])
+				return node_type{ { valve0, n.valve[1] }, { remaining0, n.remaining[1] }, pressure, open };
+			else
+				return node_type{ { n.valve[1], valve0 }, { n.remaining[1], remaining0 }, pressure, open };
+		};
+
+		ExpandMoves(reduced, n.open, n.valve[0], n.remaining[0], n.pressure, children, make_node);
+
+		// the first one may also stop here, leaving the remaining valves to the other one
+		if (n.remaining[1] > 1)
+			children.push_back(make_node(n.valve[0], 0, n.pressure, n.open));
 	}
+};
+
+int PartTwo(std::istream& in, size_t num_threads = 0, const ResultCache* cache = nullptr)
+{
+	TRACE_SCOPE("part two", "day16");
+
+	Cave cave;
+	ReducedCave reduced;
+	MakeReducedCave(in, cave, reduced, cache);
 
 	const size_t node_AA = reduced.ValveToIndex("AA");
-	const int remaining = 26;
+	const int remaining = PART_TWO_MINUTES;
 
 	ASSERT(node_AA != reduced.npos && reduced.valves[node_AA]->name == "AA");
 
-	int best_pressure_ever = 0;
-	Visit2(reduced, node_AA, remaining, node_AA, remaining, 0, best_pressure_ever);
+	ASSERT(reduced.valves.size() <= 8*sizeof(valves_mask_t));
+
+	ThreadPool pool(num_threads);
+	Search2 search{ reduced };
+	BranchAndBound<Search2> bnb(search, pool);
+	TRACE_SCOPE("search", "day16");
+	int best_pressure_ever = bnb.Solve(Search2::node_type{ { node_AA, node_AA }, { remaining, remaining }, 0, 0 }, 0);
 
 	return best_pressure_ever;
 }
@@ -488,10 +481,28 @@ JJ=21;II
 #endif
 
 #if 0
-	int best_pressure = PartOne(in);  // 2330
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) { return PartTwo(in, 1); });
+#elif 0
+	// scaling of the parallel search from 1 to N cores
+	MeasureScaling(in, [](std::istream& in, size_t num_threads) { return PartTwo(in, num_threads); });
+#elif 0
+	ResultCache cache;
+	const std::string input = ReadAll(in);
+	int best_pressure = cache.Get<int>(ResultCache::Key("day16", "part1", std::to_string(PART_ONE_MINUTES), input), [&]() {
+		std::istringstream is(input);
+		return PartOne(is, 0, &cache);
+	});  // 2330
 	std::cout << best_pressure << std::endl;
 #else
-	int best_pressure = PartTwo(in);  // 2675
+	ResultCache cache;
+	const std::string input = ReadAll(in);
+	int best_pressure = cache.Get<int>(ResultCache::Key("day16", "part2", std::to_string(PART_TWO_MINUTES), input), [&]() {
+		std::istringstream is(input);
+		return PartTwo(is, 0, &cache);
+	});  // 2675
 	std::cout << best_pressure << std::endl;
 #endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
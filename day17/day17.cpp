@@ -19,6 +19,9 @@
 #include <set>
 
 #include "..\stuffs\Splitter.h"
+#include "..\stuffs\CycleDetector.h"
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
 
 #ifdef _DEBUG
 #include <assert.h>
@@ -124,41 +127,29 @@ void Print(const std::map<Coo, char>& board, long long y_last)
 	}
 }
 
-bool Memoize(const std::map<Coo, char>& board, size_t cnt, size_t ch_index, size_t piece_index, int x_coo, long long y_coo, size_t& delta_cnt, long long& delta_y_coo)
-{
-	static std::map<std::tuple<size_t, size_t, int>, std::pair<size_t, long long>> cycles;
-	static size_t prev_delta_cnt = 0;
-	static long long prev_delta_y_coo = -1;
-	static int contigous_cnt = 0;
+// The skyline (per column depth of the first rock below the top, capped) together
+// with jet index and piece identifies the state of the chamber
+const long long SKYLINE_DEPTH = 64;
 
-	const auto key = std::make_tuple(ch_index, piece_index, x_coo);
-	if (cycles.contains(key))
+std::vector<int> Skyline(const std::map<Coo, char>& board, long long y_last)
+{
+	std::vector<int> skyline;
+	for (int x = 1; x <= 7; ++x)
 	{
-		auto value = cycles[key];
-		delta_cnt =   cnt   - value.first;
-		delta_y_coo = y_coo - value.second;
-
-		if (prev_delta_cnt == delta_cnt && prev_delta_y_coo == delta_y_coo)
-		{
-			if (++contigous_cnt > 100)
-			{
-				// Bingo!
-				return true;
-			}
-		}
-		else
-		{
-			prev_delta_cnt = delta_cnt;
-			prev_delta_y_coo = delta_y_coo;
-			contigous_cnt = 0;
-		}
+		long long depth = 0;
+		while (depth < SKYLINE_DEPTH && !board.contains(Coo(x, y_last-depth)))
+			++depth;
+		skyline.push_back((int)depth);
 	}
-	cycles[key] = std::make_pair(cnt, y_coo);
-	return false;
+	return skyline;
 }
 
+typedef std::tuple<size_t, size_t, int, std::vector<int>> state_t;  // jet index, piece index, x coo, skyline
+
 long long PartOne(std::istream& in, size_t num_rocks)
 {
+	TRACE_SCOPE(num_rocks == 2022 ? "part one" : "part two", "day17");
+
 	std::string line;
 	if (!std::getline(in, line))
 	{
@@ -173,6 +164,7 @@ long long PartOne(std::istream& in, size_t num_rocks)
 	AddBottom(board, y);
 
 	long long y_last = 0;  // ultima riga piena
+	CycleDetector<state_t> detector;
 	for (size_t i = (size_t)-1, p = 0, cnt = 0; cnt < num_rocks; p = (p + 1) % pieces.size(), ++cnt)
 	{
 		const Piece &piece = pieces[p];
@@ -210,15 +202,8 @@ long long PartOne(std::istream& in, size_t num_rocks)
 		Copy(board, piece, x, y);
 		y_last = std::max(y_last, y);
 
-		size_t delta_cnt; long long delta_y_coo;
-		if (Memoize(board, cnt, firts_ch_index, p, x, y, delta_cnt, delta_y_coo))
-		{
-			const auto remaining = num_rocks - cnt;
-			const auto full_cycle = remaining / delta_cnt;
-			const auto last_cycle = remaining % delta_cnt;
-			if (last_cycle == 0)
-				return y_last + (full_cycle * delta_y_coo) - 1;
-		}
+		if (detector.Add(std::make_tuple(firts_ch_index, p, x, Skyline(board, y_last)), y_last))
+			return detector.Extrapolate(num_rocks-1);
 	}
 
 	return y_last;
@@ -235,10 +220,15 @@ R"(>>><<><>><<<>><>>><<<>>><<<><<<>><>><<>>
 #endif
 
 #if 0
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) { return PartOne(in, 1000000000000); });
+#elif 0
 	long long height = PartOne(in, 2022);  // 3119
 	std::cout << height << std::endl;
 #else
 	long long height = PartOne(in, 1000000000000);  // 1536994219669
 	std::cout << height << std::endl;
 #endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
@@ -16,8 +16,13 @@
 #include <functional>
 #include <map>
 #include <set>
+#include <span>
 
 #include "..\stuffs\Splitter.h"
+#include "..\stuffs\BinaryInput.h"
+#include "..\stuffs\Benchmark.h"
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
 
 #ifdef _DEBUG
 #include <assert.h>
@@ -48,8 +53,14 @@ struct Cube
 	}
 };
 
-void ParseCubes(std::istream& in, std::set<Cube>& cubes)
+// layout of Cube in input1.bin
+const std::uint32_t BINARY_VERSION = 1;
+static_assert(sizeof(Cube) == 12);
+
+void ParseCubes(std::istream& in, std::vector<Cube>& cubes)
 {
+	TRACE_SCOPE("parse", "day18");
+
 	cubes.clear();
 
 	for (std::string line; std::getline(in, line); )
@@ -61,20 +72,28 @@ void ParseCubes(std::istream& in, std::set<Cube>& cubes)
 		int y = std::atoi(triple[1].c_str());
 		int z = std::atoi(triple[2].c_str());
 
-		cubes.insert(Cube(x, y, z));
+		cubes.push_back(Cube(x, y, z));
 	}
 }
 
+// Pre-parses the input into the binary file, to be loaded by BinaryInput<Cube>
+bool WriteCubes(std::istream& in, const std::string& path)
+{
+	std::vector<Cube> cubes;
+	ParseCubes(in, cubes);
+
+	return WriteBinary<Cube>(path, 18, BINARY_VERSION, cubes);
+}
+
 inline
 bool TestFace(const std::set<Cube>& cubes, int x, int y, int z)
 {
 	return !cubes.contains(Cube(x, y, z));
 }
 
-int PartOne(std::istream& in)
+int PartOne(std::span<const Cube> list)
 {
-	std::set<Cube> cubes;
-	ParseCubes(in, cubes);
+	const std::set<Cube> cubes(list.begin(), list.end());
 
 	int face_cnt = 0;
 	for (const auto cube : cubes)
@@ -105,10 +124,9 @@ bool TestFace(const std::set<Cube>& cubes, const std::map<Cube, bool>& closure,
 	return true;
 }
 
-int PartTwo(std::istream& in)
+int PartTwo(std::span<const Cube> list)
 {
-	std::set<Cube> cubes;
-	ParseCubes(in, cubes);
+	const std::set<Cube> cubes(list.begin(), list.end());
 
 	Cube min(INT_MAX, INT_MAX, INT_MAX);
 	Cube max(INT_MIN, INT_MIN, INT_MIN);
@@ -173,6 +191,26 @@ int PartTwo(std::istream& in)
 	return face_cnt;
 }
 
+int PartOne(std::istream& in)
+{
+	TRACE_SCOPE("part one", "day18");
+
+	std::vector<Cube> cubes;
+	ParseCubes(in, cubes);
+
+	return PartOne(cubes);
+}
+
+int PartTwo(std::istream& in)
+{
+	TRACE_SCOPE("part two", "day18");
+
+	std::vector<Cube> cubes;
+	ParseCubes(in, cubes);
+
+	return PartTwo(cubes);
+}
+
 int main()
 {
 #if 0
@@ -195,10 +233,36 @@ R"(2,2,2
 #endif
 
 #if 0
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) { return PartTwo(in); });
+#elif 0
+	// text vs binary ingestion (input1.bin is written from the input)
+	WriteCubes(in, "input1.bin");
+	MeasureTime("text  ", []() {
+		std::ifstream in("input1.txt");
+		std::vector<Cube> cubes;
+		ParseCubes(in, cubes);
+		return cubes.size();
+	});
+	MeasureTime("binary", []() {
+		BinaryInput<Cube> cubes;
+		cubes.Open("input1.bin", 18, BINARY_VERSION);
+		return cubes.Records().size();
+	});
+#elif 0
+	// pre-parsed input, see WriteCubes()
+	BinaryInput<Cube> cubes;
+	if (!cubes.Open("input1.bin", 18, BINARY_VERSION))
+		return 1;
+	int faces_cnt = PartTwo(cubes.Records());  // 2072
+	std::cout << faces_cnt << std::endl;
+#elif 0
 	int faces_cnt = PartOne(in);  // 3586
 	std::cout << faces_cnt << std::endl;
 #else
 	int faces_cnt = PartTwo(in);  // 2072
 	std::cout << faces_cnt << std::endl;
 #endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
@@ -18,6 +18,11 @@
 #include <set>
 
 #include "..\stuffs\Splitter.h"
+#include "..\stuffs\BranchAndBound.h"
+#include "..\stuffs\Benchmark.h"
+#include "..\stuffs\ResultCache.h"
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
 
 #ifdef _DEBUG
 #include <assert.h>
@@ -55,10 +60,6 @@ struct BluePrint
 {
 	int                id;
 	std::vector<Cost>  costs[4];   // costs[i]  where i == ResourceType
-	int                robots[4];  // robots[i]  where i == ResourceType
-	int                avail[4];   // avail[i]  where i == ResourceType
-
-	int                best_geode;
 
 	BluePrint()
 	{
@@ -68,10 +69,22 @@ struct BluePrint
 	void Clear()
 	{
 		id = -1;
-		best_geode = 0;
 		for (int i = 0; i < _countof(costs); ++i)
-		{
 			costs[i].clear();
+	}
+};
+
+struct Factory  // state of the search: robots and resources with some minutes left
+{
+	int                robots[4];  // robots[i]  where i == ResourceType
+	int                avail[4];   // avail[i]  where i == ResourceType
+	int                minutes;
+
+	Factory(int _minutes = 0)
+		: minutes(_minutes)
+	{
+		for (int i = 0; i < _countof(robots); ++i)
+		{
 			robots[i] = 0;
 			avail[i] = 0;
 		}
@@ -127,6 +140,8 @@ BluePrint ParseBluePrint(const std::string& line)
 
 void ParseAllBluePrints(std::istream& in, std::vector< BluePrint>& blueprints)
 {
+	TRACE_SCOPE("parse", "day19");
+
 	blueprints.clear();
 
 	for (std::string line; std::getline(in, line); )
@@ -137,123 +152,134 @@ void ParseAllBluePrints(std::istream& in, std::vector< BluePrint>& blueprints)
 	}
 }
 
-bool CanBuild(const BluePrint& bp, ResourceTypes type)
+bool CanBuild(const BluePrint& bp, const Factory& f, ResourceTypes type)
 {
 	ASSERT(0 <= type && type < _countof(bp.costs));
 	for (const auto& c : bp.costs[type])
 	{
-		if (bp.avail[c.type] < c.amount)
+		if (f.avail[c.type] < c.amount)
 			return false;
 	}
 
 	return true;
 }
 
-void UpdateAvail(BluePrint& bp, bool increase)
+void UpdateAvail(Factory& f)
 {
 	// Each robot can collect 1 of its resource type per minute
 	for (int type = ResourceTypes::geode; type >= ResourceTypes::ore; --type)
-		bp.avail[type] += (increase ? +bp.robots[type] : -bp.robots[type]);
+		f.avail[type] += f.robots[type];
 }
 
-void Build(BluePrint& bp, ResourceTypes type, bool increase)
+void Build(const BluePrint& bp, Factory& f, ResourceTypes type)
 {
 	ASSERT(0 <= type && type < _countof(bp.costs));
 	for (const auto& c : bp.costs[type])
 	{
-		if (increase)
-		{
-			ASSERT(bp.avail[c.type] >= c.amount);
-			bp.avail[c.type] -= c.amount;
-		}
-		else
-		{
-			bp.avail[c.type] += c.amount;
-			ASSERT(bp.avail[c.type] >= c.amount);
-		}
+		ASSERT(f.avail[c.type] >= c.amount);
+		f.avail[c.type] -= c.amount;
 	}
 
-	bp.robots[type] += (increase ? +1 : -1);
+	f.robots[type] += 1;
 }
 
-int ExtimateBestGeode(const BluePrint& bp, int minutes)
+int ExtimateBestGeode(const Factory& f)
 {
 	// Supponiamo di produrre un geode-robot al minuto
-	return bp.avail[geode] + (2 * bp.robots[geode] + minutes - 1) * minutes / 2;
+	return f.avail[geode] + (2 * f.robots[geode] + f.minutes - 1) * f.minutes / 2;
 }
 
-void TestBluePrint(BluePrint& bp, int minutes)
+struct GeodeSearch
 {
-	ASSERT(minutes >= 0);
+	typedef int      value_type;
+	typedef Factory  node_type;
 
-	if (minutes <= 0)
-	{
-		if (bp.best_geode < bp.avail[geode])
-			bp.best_geode = bp.avail[geode];
-		return;
-	}
+	const BluePrint& bp;
 
-	for (int type = ResourceTypes::geode; type >= ResourceTypes::ore; --type)
+	// geodes we get anyway, building nothing more
+	value_type Value(const Factory& f) const { return f.avail[geode] + f.robots[geode] * f.minutes; }
+	value_type Bound(const Factory& f) const { return ExtimateBestGeode(f); }
+
+	void Expand(const Factory& f, std::vector<Factory>& children) const
 	{
-		if (ExtimateBestGeode(bp, minutes) < bp.best_geode)
+		ASSERT(f.minutes >= 0);
+
+		if (f.minutes <= 0)
 			return;
 
-		if (CanBuild(bp, (ResourceTypes)type))
+		for (int type = ResourceTypes::geode; type >= ResourceTypes::ore; --type)
 		{
-			UpdateAvail(bp, true);
-				Build(bp, (ResourceTypes)type, true);
-					TestBluePrint(bp, minutes-1);
-				Build(bp, (ResourceTypes)type, false);
-			UpdateAvail(bp, false);
+			if (CanBuild(bp, f, (ResourceTypes)type))
+			{
+				Factory child = f;
+				UpdateAvail(child);
+				Build(bp, child, (ResourceTypes)type);
+				child.minutes -= 1;
+				children.push_back(child);
+			}
 		}
+
+		// Ricorsiona anche senza buildare nulla
+		Factory child = f;
+		UpdateAvail(child);
+		child.minutes -= 1;
+		children.push_back(child);
 	}
+};
 
-	if (ExtimateBestGeode(bp, minutes) < bp.best_geode)
-		return;
+int TestBluePrint(const BluePrint& bp, int minutes, ThreadPool& pool)
+{
+	TRACE_SCOPE("blueprint " + std::to_string(bp.id), "day19");  // inside "search"
 
-	// Ricorsiona anche senza buildare nulla
-	UpdateAvail(bp, true);
-		TestBluePrint(bp, minutes - 1);
-	UpdateAvail(bp, false);
+	GeodeSearch search{ bp };
+	BranchAndBound<GeodeSearch> bnb(search, pool);
+	return bnb.Solve(Factory(minutes), 0);
 }
 
-int PartOne(std::istream& in, const int available_minutes = 24)
+// Minutes of the two parts (also part of the cache keys of the answers)
+const int PART_ONE_MINUTES = 24;
+const int PART_TWO_MINUTES = 32;
+
+int PartOne(std::istream& in, const int available_minutes = PART_ONE_MINUTES, size_t num_threads = 0)
 {
+	TRACE_SCOPE("part one", "day19");
+
 	std::vector< BluePrint> blueprints;
 	ParseAllBluePrints(in, blueprints);
 
-	int sum = 0;
-	for (size_t i = 0; i < blueprints.size(); ++i)
+	// Blueprints are independent: each one is a task, and its search spawns more tasks into the same pool
+	ThreadPool pool(num_threads);
+	std::vector<int> geodes(blueprints.size());
 	{
-		std::cout << i+1 << '/' << blueprints.size() << " " << sum << std::endl;
-
-		auto& bp = blueprints[i];
-
-		TestBluePrint(bp, available_minutes);
-		const int quality_level = bp.id * bp.best_geode;
-		sum += quality_level;
+		TRACE_SCOPE("search", "day19");
+		ParallelFor(pool, 0, blueprints.size(), [&](size_t i) { geodes[i] = TestBluePrint(blueprints[i], available_minutes, pool); });
 	}
 
-	return sum;
+	TRACE_SCOPE("answer", "day19");
+	int quality = 0;
+	for (size_t i = 0; i < blueprints.size(); ++i)
+		quality += blueprints[i].id * geodes[i];  // quality level
+	return quality;
 }
 
-int PartTwo(std::istream& in, const int available_minutes = 32)
+int PartTwo(std::istream& in, const int available_minutes = PART_TWO_MINUTES, size_t num_threads = 0)
 {
+	TRACE_SCOPE("part two", "day19");
+
 	std::vector< BluePrint> blueprints;
 	ParseAllBluePrints(in, blueprints);
 
-	int mult = 1;
-	for (size_t i = 0; i < blueprints.size(); ++i)
+	ThreadPool pool(num_threads);
+	std::vector<int> geodes(std::min<size_t>(3, blueprints.size()));
 	{
-		if (i >= 3)
-			break;
-
-		auto& bp = blueprints[i];
-
-		TestBluePrint(bp, available_minutes);
-		mult *= bp.best_geode;
+		TRACE_SCOPE("search", "day19");
+		ParallelFor(pool, 0, geodes.size(), [&](size_t i) { geodes[i] = TestBluePrint(blueprints[i], available_minutes, pool); });
 	}
 
+	TRACE_SCOPE("answer", "day19");
+	int mult = 1;
+	for (const int g : geodes)
+		mult *= g;
 	return mult;
 }
 
@@ -269,10 +295,28 @@ R"(1:ore 4 ore.clay 2 ore.obsidian 3 ore and 14 clay.geode 2 ore and 7 obsidian.
 #endif
 
 #if 0
-	int sum = PartOne(in);  // 1624
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) { return PartTwo(in, PART_TWO_MINUTES, 1); });
+#elif 0
+	// scaling of the parallel search from 1 to N cores
+	MeasureScaling(in, [](std::istream& in, size_t num_threads) { return PartOne(in, PART_ONE_MINUTES, num_threads); });
+#elif 0
+	ResultCache cache;
+	const std::string input = ReadAll(in);
+	int sum = cache.Get<int>(ResultCache::Key("day19", "part1", std::to_string(PART_ONE_MINUTES), input), [&input]() {
+		std::istringstream is(input);
+		return PartOne(is, PART_ONE_MINUTES);
+	});  // 1624
 	std::cout << sum << std::endl;
 #else
-	int mult = PartTwo(in);  // 12628
+	ResultCache cache;
+	const std::string input = ReadAll(in);
+	int mult = cache.Get<int>(ResultCache::Key("day19", "part2", std::to_string(PART_TWO_MINUTES), input), [&input]() {
+		std::istringstream is(input);
+		return PartTwo(is, PART_TWO_MINUTES);
+	});  // 12628
 	std::cout << mult << std::endl;
 #endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
@@ -16,8 +16,13 @@
 #include <functional>
 #include <map>
 #include <set>
+#include <span>
 
 #include "..\stuffs\Splitter.h"
+#include "..\stuffs\BinaryInput.h"
+#include "..\stuffs\Benchmark.h"
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
 
 #ifdef _DEBUG
 #include <assert.h>
@@ -97,14 +102,34 @@ int64_t GetAt(const std::vector<int64_t>& values, std::vector<size_t>& perm, siz
 	return values[perm[j]];
 }
 
-int64_t Common(std::istream& in, int64_t key = 1, int shuffle_times = 1)
+// layout of the values in input1.bin (int64_t)
+const std::uint32_t BINARY_VERSION = 1;
+
+void ParseValues(std::istream& in, std::vector<int64_t>& values)
 {
-	std::vector<int64_t> values;
+	TRACE_SCOPE("parse", "day20");
+
+	values.clear();
+
 	for (std::string line; std::getline(in, line); )
-	{
-		const int64_t value = std::atoi(line.c_str());
+		values.push_back(std::atoi(line.c_str()));
+}
+
+// Pre-parses the input into the binary file, to be loaded by BinaryInput<int64_t>
+bool WriteValues(std::istream& in, const std::string& path)
+{
+	std::vector<int64_t> values;
+	ParseValues(in, values);
+
+	return WriteBinary<int64_t>(path, 20, BINARY_VERSION, values);
+}
+
+int64_t Common(std::span<const int64_t> list, int64_t key = 1, int shuffle_times = 1)
+{
+	std::vector<int64_t> values;
+	values.reserve(list.size());
+	for (const int64_t value : list)
 		values.push_back(value * key);
-	}
 
 	std::vector<size_t> perm(values.size(), 0);
 	std::vector<size_t> perm_inv(values.size(), 0);
@@ -127,8 +152,26 @@ int64_t Common(std::istream& in, int64_t key = 1, int shuffle_times = 1)
 	return sum;
 }
 
-int64_t PartOne(std::istream& in) { return Common(in,         1,  1); }
-int64_t PartTwo(std::istream& in) { return Common(in, 811589153, 10); }
+int64_t PartOne(std::span<const int64_t> values) { return Common(values,         1,  1); }
+int64_t PartTwo(std::span<const int64_t> values) { return Common(values, 811589153, 10); }
+
+int64_t PartOne(std::istream& in)
+{
+	TRACE_SCOPE("part one", "day20");
+
+	std::vector<int64_t> values;
+	ParseValues(in, values);
+	return PartOne(values);
+}
+
+int64_t PartTwo(std::istream& in)
+{
+	TRACE_SCOPE("part two", "day20");
+
+	std::vector<int64_t> values;
+	ParseValues(in, values);
+	return PartTwo(values);
+}
 
 int main()
 {
@@ -146,10 +189,36 @@ R"(1
 #endif
 
 #if 0
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) { return PartTwo(in); });
+#elif 0
+	// text vs binary ingestion (input1.bin is written from the input)
+	WriteValues(in, "input1.bin");
+	MeasureTime("text  ", []() {
+		std::ifstream in("input1.txt");
+		std::vector<int64_t> values;
+		ParseValues(in, values);
+		return values.size();
+	});
+	MeasureTime("binary", []() {
+		BinaryInput<int64_t> values;
+		values.Open("input1.bin", 20, BINARY_VERSION);
+		return values.Records().size();
+	});
+#elif 0
+	// pre-parsed input, see WriteValues()
+	BinaryInput<int64_t> values;
+	if (!values.Open("input1.bin", 20, BINARY_VERSION))
+		return 1;
+	int64_t sum = PartTwo(values.Records());  // 1640221678213
+	std::cout << sum << std::endl;
+#elif 0
 	int64_t sum = PartOne(in);  // 7395
 	std::cout << sum << std::endl;
 #else
 	int64_t sum = PartTwo(in);  // 1640221678213
 	std::cout << sum << std::endl;
 #endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
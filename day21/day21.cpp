@@ -16,8 +16,14 @@
 #include <functional>
 #include <map>
 #include <set>
+#include <span>
+#include <cstring>
 
 #include "..\stuffs\Splitter.h"
+#include "..\stuffs\BinaryInput.h"
+#include "..\stuffs\Benchmark.h"
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
 
 #ifdef _DEBUG
 #include <assert.h>
@@ -197,18 +203,98 @@ void ParseMonkeys(std::istream& in, std::map<std::string, Monkey>& monkeys)
 	}
 }
 
-Value Eval(const std::map<std::string, Monkey>& monkeys, const std::string& name)
+// Row of the expressions table (and layout of input1.bin): operands are indexes of rows
+struct MonkeyRecord
 {
-	auto it = monkeys.find(name);
-	ASSERT(it != monkeys.end() && it->second.name == name);
+	int64_t   value;    // if op == '\0'
+	uint32_t  left;
+	uint32_t  right;
+	char      name[4];
+	char      op;
+	char      pad[3];
+};
+static_assert(sizeof(MonkeyRecord) == 24);
 
-	if (it->second.op == '\0')
-		return it->second.value;
+const std::uint32_t BINARY_VERSION = 1;
+const uint32_t      NONE = UINT32_MAX;
 
-	const Value lvalue = Eval(monkeys, it->second.left);
-	const Value rvalue = Eval(monkeys, it->second.right);
+void MakeTable(const std::map<std::string, Monkey>& monkeys, std::vector<MonkeyRecord>& table)
+{
+	std::map<std::string, uint32_t> indexes;
+	for (const auto& [name, monkey] : monkeys)
+		indexes.insert(std::make_pair(name, (uint32_t)indexes.size()));
 
-	switch (it->second.op)
+	table.clear();
+	for (const auto& [name, monkey] : monkeys)
+	{
+		ASSERT(name.size() == sizeof(MonkeyRecord::name));
+
+		MonkeyRecord record = {};
+		std::memcpy(record.name, name.data(), std::min(name.size(), sizeof(record.name)));
+		record.op = monkey.op;
+		if (monkey.op == '\0')
+		{
+			ASSERT(monkey.value.poly.size() == 1 && monkey.value.poly[0].den == 1);
+			record.value = monkey.value.poly[0].num;
+		}
+		else
+		{
+			record.left  = indexes.at(monkey.left);
+			record.right = indexes.at(monkey.right);
+		}
+		table.push_back(record);
+	}
+}
+
+void ParseTable(std::istream& in, std::vector<MonkeyRecord>& table)
+{
+	TRACE_SCOPE("parse", "day21");
+
+	std::map<std::string, Monkey> monkeys;
+	ParseMonkeys(in, monkeys);
+
+	MakeTable(monkeys, table);
+}
+
+// Pre-parses the input into the binary file, to be loaded by BinaryInput<MonkeyRecord>
+bool WriteTable(std::istream& in, const std::string& path)
+{
+	std::vector<MonkeyRecord> table;
+	ParseTable(in, table);
+
+	return WriteBinary<MonkeyRecord>(path, 21, BINARY_VERSION, table);
+}
+
+uint32_t Find(std::span<const MonkeyRecord> table, const char* name)
+{
+	for (size_t i = 0; i < table.size(); ++i)
+		if (std::strncmp(table[i].name, name, sizeof(MonkeyRecord::name)) == 0)
+			return (uint32_t)i;
+
+	ASSERT(false);
+	return NONE;
+}
+
+// Value of the i-th monkey, as polynomial in the value yelled by the 'unknown' one (if any)
+Value Eval(std::span<const MonkeyRecord> table, uint32_t i, uint32_t unknown = NONE)
+{
+	ASSERT(i < table.size());
+	const MonkeyRecord& monkey = table[i];
+
+	if (i == unknown)
+	{
+		Value x(0);
+		x.poly.push_back(1);
+		return x;
+	}
+
+	if (monkey.op == '\0')
+		return Value(monkey.value);
+
+	const Value lvalue = Eval(table, monkey.left,  unknown);
+	const Value rvalue = Eval(table, monkey.right, unknown);
+
+	switch (monkey.op)
 	{
 	case '+':  return lvalue + rvalue;
 	case '-':  return lvalue - rvalue;
@@ -220,30 +306,23 @@ Value Eval(const std::map<std::string, Monkey>& monkeys, const std::string& name
 	return Value();
 }
 
-int64_t PartOne(std::istream& in)
+int64_t PartOne(std::span<const MonkeyRecord> table)
 {
-	std::map<std::string, Monkey> monkeys;
-	ParseMonkeys(in, monkeys);
-
-	const Value res = Eval(monkeys, "root");
+	const Value res = Eval(table, Find(table, "root"));
 	ASSERT(res.poly.size() == 1);
 
 	ASSERT(res.poly[0].den == 1);
 	return res.poly[0].num;
 }
 
-int64_t PartTwo(std::istream& in)
+int64_t PartTwo(std::span<const MonkeyRecord> table)
 {
-	std::map<std::string, Monkey> monkeys;
-	ParseMonkeys(in, monkeys);
-
-	ASSERT(monkeys.at("humn").op == '\0');
-	ASSERT(monkeys.at("humn").value.poly.size()  == 1);
-	monkeys.at("humn").value.poly[0] = 0;
-	monkeys.at("humn").value.poly.push_back(1);
+	const uint32_t humn = Find(table, "humn");
+	const MonkeyRecord& root = table[Find(table, "root")];
+	ASSERT(table[humn].op == '\0');
 
-	const Value lvalue = Eval(monkeys, monkeys.at("root").left);
-	const Value rvalue = Eval(monkeys, monkeys.at("root").right);
+	const Value lvalue = Eval(table, root.left,  humn);
+	const Value rvalue = Eval(table, root.right, humn);
 
 	const Value eq = lvalue - rvalue;
 	ASSERT(eq.poly.size() == 2);
@@ -254,6 +333,26 @@ int64_t PartTwo(std::istream& in)
 	return -res.num;
 }
 
+int64_t PartOne(std::istream& in)
+{
+	TRACE_SCOPE("part one", "day21");
+
+	std::vector<MonkeyRecord> table;
+	ParseTable(in, table);
+
+	return PartOne(table);
+}
+
+int64_t PartTwo(std::istream& in)
+{
+	TRACE_SCOPE("part two", "day21");
+
+	std::vector<MonkeyRecord> table;
+	ParseTable(in, table);
+
+	return PartTwo(table);
+}
+
 int main()
 {
 #if 0
@@ -279,10 +378,36 @@ hmdt: 32
 #endif
 
 #if 0
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) { return PartTwo(in); });
+#elif 0
+	// text vs binary ingestion (input1.bin is written from the input)
+	WriteTable(in, "input1.bin");
+	MeasureTime("text  ", []() {
+		std::ifstream in("input1.txt");
+		std::vector<MonkeyRecord> table;
+		ParseTable(in, table);
+		return table.size();
+	});
+	MeasureTime("binary", []() {
+		BinaryInput<MonkeyRecord> table;
+		table.Open("input1.bin", 21, BINARY_VERSION);
+		return table.Records().size();
+	});
+#elif 0
+	// pre-parsed input, see WriteTable()
+	BinaryInput<MonkeyRecord> table;
+	if (!table.Open("input1.bin", 21, BINARY_VERSION))
+		return 1;
+	int64_t eval = PartTwo(table.Records());  // 3219579395609
+	std::cout << eval << std::endl;
+#elif 0
 	int64_t eval = PartOne(in);  // 291425799367130
 	std::cout << eval << std::endl;
 #else
 	int64_t eval = PartTwo(in);  // 3219579395609
 	std::cout << eval << std::endl;
 #endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
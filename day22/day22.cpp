@@ -18,6 +18,9 @@
 #include <set>
 #include <queue>
 
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
+
 #ifdef _DEBUG
 #include <assert.h>
 #define ASSERT(x)   assert(x)
@@ -31,6 +34,8 @@ typedef std::vector<std::string> board_t;
 
 void ParseBoard(std::istream& in, board_t& board, std::string & path)
 {
+	TRACE_SCOPE("parse", "day22");
+
 	board.clear();
 
 	for (std::string line; std::getline(in, line);)
@@ -102,24 +107,6 @@ void StepX_2D(const board_t& board, const size_t ir, size_t& ic, int dx)
 	ic = new_ic;
 }
 
-void Move_2D(const board_t& board, const size_t order, size_t& ir, size_t& ic, size_t& dir, int steps)
-{
-	const auto& move = moves[dir];
-
-	if (move.dx != 0)
-	{
-		ASSERT(move.dy == 0);
-		for (; steps > 0; --steps)
-			StepX_2D(board, ir, ic, move.dx);
-	}
-	else
-	{
-		ASSERT(move.dx == 0);
-		for (; steps > 0; --steps)
-			StepY_2D(board, ir, ic, move.dy);
-	}
-}
-
 enum Edge
 {
 	Top = 0,
@@ -177,6 +164,24 @@ struct Vertex
 	auto operator <=> (const Vertex&) const = default;
 };
 
+void Move_2D(const board_t& board, const size_t order, const Vertex /*vertices*/[5][5], size_t& ir, size_t& ic, size_t& dir, int steps)
+{
+	const auto& move = moves[dir];
+
+	if (move.dx != 0)
+	{
+		ASSERT(move.dy == 0);
+		for (; steps > 0; --steps)
+			StepX_2D(board, ir, ic, move.dx);
+	}
+	else
+	{
+		ASSERT(move.dx == 0);
+		for (; steps > 0; --steps)
+			StepY_2D(board, ir, ic, move.dy);
+	}
+}
+
 void AssignVerticies(
 	Vertex vertices[5][5],
 	const RowCol src[4],
@@ -603,16 +608,8 @@ void StepX_3D(const board_t& board, const size_t order, const Vertex vertices[5]
 	}
 }
 
-void Move_3D(const board_t& board, const size_t order, size_t& ir, size_t& ic, size_t& dir, int steps)
+void Move_3D(const board_t& board, const size_t order, const Vertex vertices[5][5], size_t& ir, size_t& ic, size_t& dir, int steps)
 {
-	static Vertex vertices[5][5];
-	static bool one_time_init = false;
-	if (!one_time_init)
-	{
-		UnfoldVerticies_3D(board, order, vertices);
-		one_time_init = true;
-	}
-
 	for (; steps > 0; --steps)
 	{
 		const auto& move = moves[dir];
@@ -630,7 +627,7 @@ void Move_3D(const board_t& board, const size_t order, size_t& ir, size_t& ic, s
 	}
 }
 
-typedef void (*tMover)(const board_t& board, size_t order, size_t& ir, size_t& ic, size_t& dir, int steps);
+typedef void (*tMover)(const board_t& board, size_t order, const Vertex vertices[5][5], size_t& ir, size_t& ic, size_t& dir, int steps);
 
 int PartCommon(std::istream& in, tMover mover, const size_t order)
 {
@@ -638,6 +635,10 @@ int PartCommon(std::istream& in, tMover mover, const size_t order)
 	std::string path;
 	ParseBoard(in, board, path);
 
+	Vertex vertices[5][5];  // of the unfolded cube (order > 0 only)
+	if (order > 0)
+		UnfoldVerticies_3D(board, order, vertices);
+
 	size_t ir, ic;
 	FindStartingTile(board, ir, ic);
 
@@ -650,7 +651,7 @@ int PartCommon(std::istream& in, tMover mover, const size_t order)
 			const long long steps = std::strtol(path.c_str() + i_beg, &pEnd, 10);
 			i_end = pEnd - path.c_str();
 
-			(*mover)(board, order, ir, ic, dir, (int)steps);
+			(*mover)(board, order, vertices, ir, ic, dir, (int)steps);
 		}
 		else
 		{
@@ -664,8 +665,19 @@ int PartCommon(std::istream& in, tMover mover, const size_t order)
 	return 1000*(int)(ir+1) + 4*(int)(ic+1) + (int)dir;
 }
 
-int PartOne(std::istream& in)               { return PartCommon(in, &Move_2D,     0); }
-int PartTwo(std::istream& in, size_t order) { return PartCommon(in, &Move_3D, order); }
+int PartOne(std::istream& in)
+{
+	TRACE_SCOPE("part one", "day22");
+
+	return PartCommon(in, &Move_2D, 0);
+}
+
+int PartTwo(std::istream& in, size_t order)
+{
+	TRACE_SCOPE("part two", "day22");
+
+	return PartCommon(in, &Move_3D, order);
+}
 
 int main()
 {
@@ -692,10 +704,15 @@ R"(        ...#
 #endif
 
 #if 0
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [order](std::istream& in) { return PartTwo(in, order); });
+#elif 0
 	int final_password = PartOne(in);  // 76332
 	std::cout << final_password << std::endl;
 #else
 	int final_password = PartTwo(in, order);  // 144012
 	std::cout << final_password << std::endl;
 #endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
@@ -17,6 +17,9 @@
 #include <map>
 #include <set>
 
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
+
 #ifdef _DEBUG
 #include <assert.h>
 #define ASSERT(x)   assert(x)
@@ -90,6 +93,8 @@ typedef std::map<Coo, size_t> index_t;
 
 void ParseBoard(std::istream& in, board_t& board)
 {
+	TRACE_SCOPE("parse", "day23");
+
 	board.clear();
 
 	int row = 0;
@@ -279,6 +284,8 @@ int PerformRounds(board_t& board, int rounds_limit = -1)
 
 int PartOne(std::istream& in)
 {
+	TRACE_SCOPE("part one", "day23");
+
 	board_t board;
 	ParseBoard(in, board);
 
@@ -307,6 +314,8 @@ int PartOne(std::istream& in)
 
 int PartTwo(std::istream& in)
 {
+	TRACE_SCOPE("part two", "day23");
+
 	board_t board;
 	ParseBoard(in, board);
 
@@ -343,10 +352,15 @@ R"(..............
 #endif
 
 #if 0
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) { return PartTwo(in); });
+#elif 0
 	int ground_count = PartOne(in);  // 4158
 	std::cout << ground_count << std::endl;
 #else
 	int round_count = PartTwo(in);  // 1014
 	std::cout << round_count << std::endl;
 #endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
@@ -18,6 +18,10 @@
 #include <set>
 
 #include "..\stuffs\Dijkstra.h"
+#include "..\stuffs\CycleDetector.h"
+#include "..\stuffs\ResultCache.h"
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
 
 #ifdef _DEBUG
 #include <assert.h>
@@ -72,6 +76,8 @@ struct Blizzard
 		, iMove(_iMove)
 	{
 	}
+
+	bool operator == (const Blizzard&) const = default;
 };
 
 typedef std::vector<Blizzard> blizzards_t;
@@ -80,6 +86,8 @@ typedef std::vector<board_t>  timed_board_t;  // add time dimension (minutes)
 
 void ParseInitialBoard(std::istream& in, blizzards_t& blizzards, int& width, int& height, Coo& entrance, Coo& exit)
 {
+	TRACE_SCOPE("parse", "day24");
+
 	blizzards.clear();
 	width = height = 0;
 
@@ -256,6 +264,8 @@ void AddEdgesToGraph(graph_t& graph, std::map <TimedCoo, size_t>& coo2node, cons
 
 void BoardsToGraph(const timed_board_t& boards, const int width, const int height, const size_t iCycle, const Coo& entrance, const Coo& exit, graph_t& graph, size_t& iEntrance, size_t& iExit)
 {
+	TRACE_SCOPE("graph build", "day24");
+
 	graph.Clear();
 	std::map <TimedCoo, size_t> coo2node;
 
@@ -328,45 +338,57 @@ void Print(const board_t& board, const int width, const int height)
 	std::cout << std::endl;
 }
 
-int Solve(const blizzards_t& _blizzards, const int width, const int height, const Coo& entrance, const Coo& exit, const int initial_minute)
+// Blizzards positions are periodic: find where the cycle starts and its length (from the cache, when available)
+std::pair<size_t, size_t> FindPeriod(const blizzards_t& blizzards, const int width, const int height, const ResultCache* cache, const std::string& key)
+{
+	TRACE_SCOPE("period", "day24");
+
+	std::string text;
+	if (cache != nullptr && cache->Load(key, text))
+	{
+		std::istringstream is(text);
+		size_t iCycle, cycle_len;
+		if (is >> iCycle >> cycle_len)
+			return std::make_pair(iCycle, cycle_len);
+	}
+
+	const auto period = FindCycle(blizzards, [width, height](blizzards_t blz) {
+		MoveBlizzards(blz, width, height);
+		return blz;
+	});
+
+	if (cache != nullptr)
+		cache->Store(key, std::to_string(period.first) + ' ' + std::to_string(period.second));
+
+	return period;
+}
+
+int Solve(const blizzards_t& _blizzards, const int width, const int height, const Coo& entrance, const Coo& exit, const int initial_minute, const ResultCache* cache = nullptr, std::string_view input = {})
 {
 	blizzards_t blizzards = _blizzards;
 
 	for (int minute = 0; minute < initial_minute; ++minute)
 		MoveBlizzards(blizzards, width, height);
 
-	const int time_limit = 10000;
+	const auto [iCycle, cycle_len] = FindPeriod(blizzards, width, height, cache, ResultCache::Key("day24", "period", std::to_string(initial_minute), input));
 
-	size_t iCycle = (size_t)-1;
 	timed_board_t boards;
-	for (int minute = 0; minute < time_limit; ++minute)
 	{
-		board_t board;
-		MakeBoard(blizzards, board);
+		TRACE_SCOPE("boards", "day24");
+		for (size_t minute = 0; minute < iCycle+cycle_len; ++minute)
+		{
+			board_t board;
+			MakeBoard(blizzards, board);
 
 #if 0
-		std::cout << "--- minute " << minute << " ---" << std::endl;
-		Print(board, width, height);
+			std::cout << "--- minute " << minute << " ---" << std::endl;
+			Print(board, width, height);
 #endif
 
-		// check if 'board' closes a cycle into boards sequence
-		auto it = std::find(boards.begin(), boards.end(), board);
-		if (it != boards.end())
-		{
-			// bingo!
-			iCycle = it-boards.begin();
-			break;
-		}
-
-		boards.push_back(std::move(board));
-
-		MoveBlizzards(blizzards, width, height);
-	}
+			boards.push_back(std::move(board));
 
-	if (iCycle == (size_t)-1)
-	{
-		ASSERT(false);  // no cycles in blizzards movements!
-		return -1;
+			MoveBlizzards(blizzards, width, height);
+		}
 	}
 
 	// Translate boards into a directed graph
@@ -376,33 +398,46 @@ int Solve(const blizzards_t& _blizzards, const int width, const int height, cons
 
 	std::vector<int> dist;
 	std::vector<size_t> path;
-	Dijkstra(graph, iEntrance, iExit, path, dist);
+	{
+		TRACE_SCOPE("search", "day24");
+		Dijkstra(graph, iEntrance, iExit, path, dist);
+	}
 	ASSERT(path[iExit] != graph.npos);
 
 	return dist[iExit];
 }
 
-int PartOne(std::istream& in)
+int PartOne(std::istream& in, const ResultCache* cache = nullptr)
 {
+	TRACE_SCOPE("part one", "day24");
+
+	const std::string input = ReadAll(in);
+	std::istringstream is(input);
+
 	int width, height;
 	Coo entrance, exit;
 	blizzards_t blizzards;
-	ParseInitialBoard(in, blizzards, width, height, entrance, exit);
+	ParseInitialBoard(is, blizzards, width, height, entrance, exit);
 
-	return Solve(blizzards, width, height, entrance, exit, 0);
+	return Solve(blizzards, width, height, entrance, exit, 0, cache, input);
 }
 
-int PartTwo(std::istream& in)
+int PartTwo(std::istream& in, const ResultCache* cache = nullptr)
 {
+	TRACE_SCOPE("part two", "day24");
+
+	const std::string input = ReadAll(in);
+	std::istringstream is(input);
+
 	int width, height;
 	Coo entrance, exit;
 	blizzards_t blizzards;
-	ParseInitialBoard(in, blizzards, width, height, entrance, exit);
+	ParseInitialBoard(is, blizzards, width, height, entrance, exit);
 
 	int initial_minute = 0;
-	const int step0 = Solve(blizzards, width, height, entrance, exit, initial_minute);  initial_minute += step0;
-	const int step1 = Solve(blizzards, width, height, exit, entrance, initial_minute);  initial_minute += step1;
-	const int step2 = Solve(blizzards, width, height, entrance, exit, initial_minute);
+	const int step0 = Solve(blizzards, width, height, entrance, exit, initial_minute, cache, input);  initial_minute += step0;
+	const int step1 = Solve(blizzards, width, height, exit, entrance, initial_minute, cache, input);  initial_minute += step1;
+	const int step2 = Solve(blizzards, width, height, entrance, exit, initial_minute, cache, input);
 
 	return step0 + step1 + step2;
 }
@@ -421,11 +456,25 @@ R"(#.######
 	std::ifstream in("input1.txt");
 #endif
 
+	ResultCache cache;
+	const std::string input = ReadAll(in);
+
 #if 0
-	int best_minutes = PartOne(in);  // 290
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) { return PartTwo(in); });
+#elif 0
+	int best_minutes = cache.Get<int>(ResultCache::Key("day24", "part1", "", input), [&]() {
+		std::istringstream is(input);
+		return PartOne(is, &cache);
+	});  // 290
 	std::cout << best_minutes << std::endl;
 #else
-	int best_minutes = PartTwo(in);  // 842
+	int best_minutes = cache.Get<int>(ResultCache::Key("day24", "part2", "", input), [&]() {
+		std::istringstream is(input);
+		return PartTwo(is, &cache);
+	});  // 842
 	std::cout << best_minutes << std::endl;
 #endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
@@ -18,6 +18,12 @@
 #include <set>
 
 #include "..\stuffs\Splitter.h"
+#include "..\stuffs\LineReader.h"
+#include "..\stuffs\ChunkReduce.h"
+#include "..\stuffs\BinaryInput.h"
+#include "..\stuffs\Benchmark.h"
+#include "..\stuffs\Batch.h"
+#include "..\stuffs\Trace.h"
 
 #ifdef _DEBUG
 #include <assert.h>
@@ -29,14 +35,14 @@
 
 
 
-static const std::string digits = "=-012";
+constexpr std::string_view digits = "=-012";
 
-int64_t SNAFU2Decimal(const std::string& snafu)
+constexpr int64_t SNAFU2Decimal(std::string_view snafu)
 {
 	int64_t decimal = 0, pow5 = 1;
 	for (auto it = snafu.rbegin(); it != snafu.rend(); ++it, pow5 *= 5)
 	{
-		ASSERT(digits.find(*it) != std::string::npos);
+		ASSERT(digits.find(*it) != std::string_view::npos);
 		int64_t digit = (int64_t)digits.find(*it) - 2;
 		ASSERT(-2 <= digit && digit <= 2);
 
@@ -46,7 +52,7 @@ int64_t SNAFU2Decimal(const std::string& snafu)
 	return decimal;
 }
 
-std::string Decimal2SNAFU(int64_t decimal)
+constexpr std::string Decimal2SNAFU(int64_t decimal)
 {
 	std::string snafu;
 	while (decimal > 0)
@@ -100,22 +106,49 @@ void Test()
 	}
 }
 
+// Single pass, constant memory
 std::string PartOne(std::istream& in)
 {
+	TRACE_SCOPE("part one", "day25");
+
 	int64_t sum = 0;
-	for (std::string line; std::getline(in, line); )
-	{
+	ForEachLine(in, [&](std::string_view line) {
+		if (line.empty())
+			return;
+
 		const int64_t snafu = SNAFU2Decimal(line);
 		sum += snafu;
-	}
+	});
 
 	return Decimal2SNAFU(sum);
 }
 
-int main()
+// Whole input in memory
+constexpr std::string PartOne(std::string_view data)
 {
-#if 0
-	std::istringstream in(
+	int64_t sum = 0;
+	ForEachLine(data, [&](std::string_view line) {
+		if (!line.empty())
+			sum += SNAFU2Decimal(line);
+	});
+
+	return Decimal2SNAFU(sum);
+}
+
+// Chunks of the input in parallel
+std::string PartOne(std::string_view data, size_t num_threads)
+{
+	ThreadPool pool(num_threads);
+
+	const int64_t sum = SumLines<int64_t>(pool, data, [](std::string_view line) {
+		return line.empty() ? 0 : SNAFU2Decimal(line);
+	});
+
+	return Decimal2SNAFU(sum);
+}
+
+// sample of the puzzle, solved at compile time
+constexpr std::string_view SAMPLE =
 R"(1=-0-2
 12111
 2=0=
@@ -128,16 +161,38 @@ R"(1=-0-2
 1-12
 12
 1=
-122)");
+122)";
+
+static_assert(PartOne(SAMPLE) == "2=-1=0");
+
+int main()
+{
+#if 0
+	std::istringstream in{std::string(SAMPLE)};
 #else
 	std::ifstream in("input1.txt");
 #endif
 
 //	Test();
 
-#if 1
+#if 0
+	// batch mode: all the inputs of a directory (or listed by a manifest), concurrently
+	RunBatch("inputs", [](std::istream& in) { return PartOne(in); });
+#elif 0
+	// streaming a (possibly huge) input from stdin: throughput and peak memory
+	MeasureStream(std::cin, [](std::istream& in) { return PartOne(in); });
+#elif 0
+	// chunks of the mapped input in parallel, from 1 to N cores
+	MappedFile file;
+	if (!file.Open("input1.txt"))
+		return 1;
+	const std::string_view data(file.Data(), file.Size());
+	MeasureScaling(in, [&](std::istream&, size_t num_threads) { return PartOne(data, num_threads); });
+#elif 1
 	std::string snafu = PartOne(in);  // 2=-0=1-0012-=-2=0=01
 	std::cout << snafu << std::endl;
 #else
 #endif
+
+	TRACE_SAVE("trace.json");  // with AOC_TRACE: open it in chrome://tracing
 }
@@ -0,0 +1,99 @@
+// (c) 2023 Federico Molara <federico@molara.net>
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include "ThreadPool.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Inputs of a batch: the files of a directory (sorted by name), or the files listed
+// by a manifest, one per line (relative paths are relative to the manifest)
+inline std::vector<std::filesystem::path> ListInputs(const std::filesystem::path& path)
+{
+    std::vector<std::filesystem::path> inputs;
+
+    std::error_code ec;
+    if (std::filesystem::is_directory(path, ec))
+    {
+        for (const auto& entry : std::filesystem::directory_iterator(path, ec))
+            if (entry.is_regular_file(ec))
+                inputs.push_back(entry.path());
+        std::sort(inputs.begin(), inputs.end());
+        return inputs;
+    }
+
+    std::ifstream manifest(path);
+    for (std::string line; std::getline(manifest, line); )
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty())
+            continue;
+
+        const std::filesystem::path input(line);
+        inputs.push_back(input.is_relative() ? path.parent_path() / input : input);
+    }
+    return inputs;
+}
+
+// Nearest-rank percentile of sorted values
+inline double Percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+
+    const size_t rank = (size_t)std::ceil(p / 100 * sorted.size());
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+// Solves all the inputs of a batch (see ListInputs) concurrently, 'solve(in)' being run
+// by the threads of one shared pool: prints the answers, in the order of the inputs,
+// then inputs per second and p50 / p99 latency of the single inputs
+template <typename TSolve>
+void RunBatch(const std::string& path, TSolve solve, size_t num_threads = 0)
+{
+    const std::vector<std::filesystem::path> inputs = ListInputs(path);
+
+    std::vector<std::string> answers(inputs.size());
+    std::vector<double> latencies(inputs.size(), 0);  // ms
+
+    ThreadPool pool(num_threads);
+
+    const auto start = std::chrono::steady_clock::now();
+    ParallelFor(pool, 0, inputs.size(), [&](size_t i) {
+        TRACE_SCOPE(inputs[i].filename().string(), "batch");  // the phases of the solver nest inside
+
+        const auto input_start = std::chrono::steady_clock::now();
+
+        std::ifstream in(inputs[i]);
+        std::ostringstream answer;
+        if (in)
+            answer << solve(in);
+        else
+            answer << "<cannot open>";
+        answers[i] = answer.str();
+
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - input_start;
+        latencies[i] = elapsed.count();
+    });
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    for (size_t i = 0; i < inputs.size(); ++i)
+        std::cout << inputs[i].string() << ": " << answers[i] << std::endl;
+
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << inputs.size() << " inputs, " << pool.Size() << " threads: "
+              << elapsed.count() * 1000 << " ms  "
+              << (elapsed.count() > 0 ? inputs.size() / elapsed.count() : 0) << " inputs/s  "
+              << "p50 " << Percentile(latencies, 50) << " ms  "
+              << "p99 " << Percentile(latencies, 99) << " ms" << std::endl;
+}
@@ -0,0 +1,162 @@
+// (c) 2023 Federico Molara <federico@molara.net>
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+    #include <psapi.h>
+    #pragma comment(lib, "psapi.lib")
+#else
+    #include <sys/resource.h>
+#endif
+
+// Runs 'solve(in, num_threads)' with 1 to N threads (N == cores by default), rewinding
+// the input every time, and prints answer, elapsed time and speedup over 1 thread
+template <typename TSolve>
+void MeasureScaling(std::istream& in, TSolve solve, size_t max_threads = 0)
+{
+    if (max_threads == 0)
+        max_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+    double elapsed_1 = 0;
+    for (size_t num_threads = 1; num_threads <= max_threads; ++num_threads)
+    {
+        in.clear();
+        in.seekg(0);
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto answer = solve(in, num_threads);
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        if (num_threads == 1)
+            elapsed_1 = elapsed.count();
+
+        std::cout << num_threads << " threads: " << answer << "  " << elapsed.count() << " ms  x" << elapsed_1 / elapsed.count() << std::endl;
+    }
+}
+
+// Runs 'func()' 'repeat' times and prints its result and the best elapsed time
+template <typename TFunc>
+void MeasureTime(const char* label, TFunc func, size_t repeat = 10)
+{
+    double best = 0;
+    for (size_t i = 0; i < repeat; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const auto answer = func();
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        if (i == 0 || elapsed.count() < best)
+            best = elapsed.count();
+
+        if (i+1 == repeat)
+            std::cout << label << ": " << answer << "  " << best << " ms" << std::endl;
+    }
+}
+
+// Seeded generator of the synthetic inputs of the benchmarks: xorshift64, fast and
+// reproducible (the same seed, the same input). constexpr, for compile-time checks too
+class SyntheticRng
+{
+public:
+    constexpr explicit SyntheticRng(uint64_t seed = 1)
+        : _state(seed != 0 ? seed : 1)  // 0 is a fixed point
+    {
+    }
+
+    constexpr uint64_t Next()
+    {
+        _state ^= _state << 13;
+        _state ^= _state >> 7;
+        _state ^= _state << 17;
+        return _state;
+    }
+
+    // in [0, n), n > 0
+    constexpr uint64_t Below(uint64_t n)
+    {
+        return Next() % n;
+    }
+
+private:
+    uint64_t  _state;
+};
+
+// Peak resident memory of the process, in KiB
+inline size_t PeakMemoryKiB()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return counters.PeakWorkingSetSize / 1024;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return (size_t)usage.ru_maxrss;  // KiB on Linux
+#endif
+}
+
+// Read-only stream buffer that counts the bytes read from another one
+class CountingStreamBuf : public std::streambuf
+{
+public:
+    explicit CountingStreamBuf(std::streambuf* source, size_t buffer_size = 1 << 16)
+        : _source(source)
+        , _buffer(buffer_size)
+        , _count(0)
+    {
+    }
+
+    size_t Count() const { return _count; }
+
+protected:
+    int_type underflow() override
+    {
+        const std::streamsize read = _source->sgetn(_buffer.data(), (std::streamsize)_buffer.size());
+        if (read <= 0)
+            return traits_type::eof();
+
+        _count += (size_t)read;
+        setg(_buffer.data(), _buffer.data(), _buffer.data() + read);
+        return traits_type::to_int_type(_buffer[0]);
+    }
+
+private:
+    std::streambuf*    _source;
+    std::vector<char>  _buffer;
+    size_t             _count;
+};
+
+// Runs 'solve(in)' once over a (possibly piped, huge) input and prints answer, elapsed
+// time, throughput and peak memory of the process
+template <typename TSolve>
+void MeasureStream(std::istream& in, TSolve solve)
+{
+    CountingStreamBuf counter(in.rdbuf());
+    std::istream counted(&counter);
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto answer = solve(counted);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const double mib = counter.Count() / (1024.0 * 1024.0);
+    std::cout << answer << "  " << mib << " MiB  " << elapsed.count() * 1000 << " ms  "
+              << mib / elapsed.count() << " MiB/s  peak " << PeakMemoryKiB() << " KiB" << std::endl;
+}
@@ -0,0 +1,170 @@
+// (c) 2023 Federico Molara <federico@molara.net>
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <string>
+#include <type_traits>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+// Pre-parsed input: a versioned binary file of fixed size records, meant to be memory-mapped
+//     BinaryHeader | record[0] | record[1] | ... | record[count-1]
+struct BinaryHeader
+{
+    char           magic[4];     // "AoCb"
+    std::uint32_t  day;
+    std::uint32_t  version;      // of the record layout: bump it at every change
+    std::uint32_t  record_size;  // sizeof(record)
+    std::uint64_t  count;        // number of records
+};
+static_assert(sizeof(BinaryHeader) == 24 && sizeof(BinaryHeader) % 8 == 0);
+
+template <typename T>
+bool WriteBinary(const std::string& path, std::uint32_t day, std::uint32_t version, std::span<const T> records)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    BinaryHeader header;
+    std::memcpy(header.magic, "AoCb", 4);
+    header.day = day;
+    header.version = version;
+    header.record_size = sizeof(T);
+    header.count = records.size();
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(records.data()), records.size_bytes());
+    return (bool)file;
+}
+
+// Read-only memory mapping of a whole file
+class MappedFile
+{
+public:
+    MappedFile()
+        : _data(nullptr)
+        , _size(0)
+    {
+    }
+
+    ~MappedFile()
+    {
+        Close();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator = (const MappedFile&) = delete;
+
+    bool Open(const std::string& path)
+    {
+        Close();
+
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER size;
+        HANDLE mapping = nullptr;
+        if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr)
+            return false;
+
+        _data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+        if (_data == nullptr)
+            return false;
+        _size = (size_t)size.QuadPart;
+#else
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        void* data = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+            data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED)
+            return false;
+
+        _data = static_cast<const char*>(data);
+        _size = (size_t)st.st_size;
+#endif
+        return true;
+    }
+
+    void Close()
+    {
+        if (_data == nullptr)
+            return;
+
+#ifdef _WIN32
+        UnmapViewOfFile(_data);
+#else
+        munmap(const_cast<char*>(_data), _size);
+#endif
+        _data = nullptr;
+        _size = 0;
+    }
+
+    const char* Data() const { return _data; }
+    size_t Size() const { return _size; }
+
+private:
+    const char*  _data;
+    size_t       _size;
+};
+
+// Records of a pre-parsed input, straight from the mapped file (no parsing, no copies)
+template <typename T>
+class BinaryInput
+{
+public:
+    bool Open(const std::string& path, std::uint32_t day, std::uint32_t version)
+    {
+        static_assert(std::is_trivially_copyable_v<T> && alignof(T) <= 8);
+
+        _records = {};
+        if (!_file.Open(path) || _file.Size() < sizeof(BinaryHeader))
+            return false;
+
+        const auto header = reinterpret_cast<const BinaryHeader*>(_file.Data());
+        if (std::memcmp(header->magic, "AoCb", 4) != 0 || header->day != day || header->version != version || header->record_size != sizeof(T))
+            return false;
+        if (_file.Size() != sizeof(BinaryHeader) + header->count * sizeof(T))
+            return false;
+
+        _records = std::span<const T>(reinterpret_cast<const T*>(_file.Data() + sizeof(BinaryHeader)), (size_t)header->count);
+        return true;
+    }
+
+    std::span<const T> Records() const { return _records; }
+
+private:
+    MappedFile          _file;
+    std::span<const T>  _records;
+};
@@ -0,0 +1,109 @@
+// (c) 2023 Federico Molara <federico@molara.net>
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include "ThreadPool.h"
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+// Parallel depth-first branch-and-bound (maximization).
+//
+// TProblem is shared read-only by all the workers and provides:
+//     typedef ... node_type;   // copyable search state (every worker owns its copies)
+//     typedef ... value_type;  // integral value
+//     value_type Value(const node_type&) const;   // value of the node as a solution
+//     value_type Bound(const node_type&) const;   // optimistic extimate of the whole subtree
+//     void Expand(const node_type&, std::vector<node_type>& children) const;  // append children, best first
+//
+// Nodes shallower than 'split_depth' become tasks of the pool, that idle threads can steal
+// (the shallowest first); deeper subtrees are searched recursively by the thread that
+// owns them. The incumbent is shared and atomic.
+template <typename TProblem>
+class BranchAndBound
+{
+public:
+    using node_type = typename TProblem::node_type;
+    using value_type = typename TProblem::value_type;
+
+public:
+    BranchAndBound(const TProblem& problem, ThreadPool& pool, size_t split_depth = 4)
+        : _problem(problem)
+        , _pool(pool)
+        , _split_depth(split_depth)
+        , _incumbent(0)
+    {
+    }
+
+    value_type Solve(const node_type& root, value_type incumbent)
+    {
+        _incumbent = std::max(incumbent, _problem.Value(root));
+
+        TaskGroup group(_pool);
+        Spawn(group, root, 0);
+        group.Wait();
+
+        return _incumbent;
+    }
+
+    value_type Incumbent() const { return _incumbent; }
+
+private:
+    void Improve(value_type value)
+    {
+        value_type curr = _incumbent.load(std::memory_order_relaxed);
+        while (curr < value && !_incumbent.compare_exchange_weak(curr, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void Spawn(TaskGroup& group, const node_type& node, size_t depth)
+    {
+        group.Run([this, &group, node, depth]() {
+            Process(group, node, depth);
+        });
+    }
+
+    void Process(TaskGroup& group, const node_type& node, size_t depth)
+    {
+        if (depth >= _split_depth)
+        {
+            TRACE_SCOPE("subtree", "search");  // on the track of the thread that owns it
+            std::vector<std::vector<node_type>> scratch;  // children per level, reused
+            Search(node, 0, scratch);
+            return;
+        }
+
+        Improve(_problem.Value(node));
+        if (_problem.Bound(node) <= _incumbent.load(std::memory_order_relaxed))
+            return;
+
+        std::vector<node_type> children;
+        _problem.Expand(node, children);
+        for (auto it = children.rbegin(); it != children.rend(); ++it)  // best child on top
+            Spawn(group, *it, depth+1);
+    }
+
+    void Search(const node_type& node, size_t level, std::vector<std::vector<node_type>>& scratch)
+    {
+        Improve(_problem.Value(node));
+        if (_problem.Bound(node) <= _incumbent.load(std::memory_order_relaxed))
+            return;
+
+        if (scratch.size() <= level)
+            scratch.resize(level+1);
+
+        scratch[level].clear();
+        _problem.Expand(node, scratch[level]);
+        for (size_t i = 0; i < scratch[level].size(); ++i)
+            Search(scratch[level][i], level+1, scratch);
+    }
+
+private:
+    const TProblem&           _problem;
+    ThreadPool&               _pool;
+    const size_t              _split_depth;
+    std::atomic<value_type>   _incumbent;
+};
@@ -0,0 +1,102 @@
+// (c) 2023 Federico Molara <federico@molara.net>
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include "LineReader.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+// Record boundaries: the first record that starts at or after 'pos'
+
+// records are lines
+inline size_t NextLine(std::string_view data, size_t pos)
+{
+    if (pos == 0 || pos >= data.size())
+        return std::min(pos, data.size());
+
+    const size_t nl = data.find('\n', pos - 1);
+    return nl == std::string_view::npos ? data.size() : nl + 1;
+}
+
+// records are groups of lines, separated by blank lines
+inline size_t NextGroup(std::string_view data, size_t pos)
+{
+    for (pos = NextLine(data, pos); pos < data.size(); pos = NextLine(data, pos + 1))
+        if (data[pos] == '\n' || data[pos] == '\r')  // blank line: the group starts after it
+            return NextLine(data, pos + 1);
+
+    return data.size();
+}
+
+// Splits 'data' in (about) 'n' chunks of whole records
+template <typename TNext>
+std::vector<std::string_view> SplitChunks(std::string_view data, size_t n, TNext next)
+{
+    std::vector<std::string_view> chunks;
+    for (size_t begin = 0, k = 1; begin < data.size(); ++k)
+    {
+        const size_t end = (k < n) ? std::max(begin, next(data, data.size() / n * k)) : data.size();
+        if (end > begin)
+            chunks.push_back(data.substr(begin, end - begin));
+        begin = end;
+    }
+    return chunks;
+}
+
+// Splits 'data' in (about) 'n' chunks of whole records, a record being 'lines' lines: the
+// lines of every chunk are counted in parallel, then the cuts move forward to the next record
+inline std::vector<std::string_view> SplitLineRecords(ThreadPool& pool, std::string_view data, size_t n, size_t lines)
+{
+    std::vector<std::string_view> chunks = SplitChunks(data, n, NextLine);
+    if (lines <= 1)
+        return chunks;
+
+    std::vector<size_t> counts(chunks.size(), 0);
+    ParallelFor(pool, 0, chunks.size(), [&](size_t i) {
+        counts[i] = std::count(chunks[i].begin(), chunks[i].end(), '\n');
+    });
+
+    std::vector<std::string_view> aligned;
+    size_t begin = 0;  // in data
+    size_t line = 0;   // lines before the end of chunks[i]
+    for (size_t i = 0; i < chunks.size(); ++i)
+    {
+        size_t end = chunks[i].data() + chunks[i].size() - data.data();
+        line += counts[i];
+        for (size_t skip = (lines - line % lines) % lines; skip > 0 && end < data.size(); --skip)
+            end = NextLine(data, end + 1);
+
+        if (end > begin)
+        {
+            aligned.push_back(data.substr(begin, end - begin));
+            begin = end;
+        }
+    }
+    return aligned;
+}
+
+// Reduces the chunks in parallel, reduce(chunk) -> T, merging the partial results in order
+template <typename T, typename TReduce, typename TMerge>
+T ReduceChunks(ThreadPool& pool, const std::vector<std::string_view>& chunks, T identity, TReduce reduce, TMerge merge)
+{
+    return ParallelReduce(pool, 0, chunks.size(), identity,
+        [&](size_t i) { return reduce(chunks[i]); },
+        merge);
+}
+
+// Sum of value(line) over all the lines of 'data', chunks of lines in parallel
+template <typename T, typename TValue>
+T SumLines(ThreadPool& pool, std::string_view data, TValue value)
+{
+    const auto chunks = SplitChunks(data, 4 * pool.Size(), NextLine);
+    return ReduceChunks(pool, chunks, T(),
+        [&](std::string_view chunk) {
+            T sum = T();
+            ForEachLine(chunk, [&](std::string_view line) { sum += value(line); });
+            return sum;
+        },
+        [](const T& l, const T& r) { return l + r; });
+}
@@ -0,0 +1,134 @@
+// (c) 2023 Federico Molara <federico@molara.net>
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include <map>
+#include <stdexcept>
+#include <vector>
+#include <utility>
+
+// Brent's algorithm: finds (mu, lambda) of the sequence x0, f(x0), f(f(x0)), ...
+// where mu is the index of the first state of the cycle and lambda is its length.
+// Memory is O(1) in the number of steps; TState only needs operator ==.
+template <typename TState, typename TFunc>
+std::pair<size_t, size_t> FindCycle(const TState& x0, TFunc f)
+{
+    // STEP 1: find lambda (search successive powers of two)
+    size_t power = 1;
+    size_t lambda = 1;
+    TState tortoise = x0;
+    TState hare = f(x0);
+    while (!(tortoise == hare))
+    {
+        if (power == lambda)
+        {
+            tortoise = hare;
+            power *= 2;
+            lambda = 0;
+        }
+        hare = f(hare);
+        ++lambda;
+    }
+
+    // STEP 2: find mu (hare starts lambda steps ahead of tortoise)
+    tortoise = x0;
+    hare = x0;
+    for (size_t i = 0; i < lambda; ++i)
+        hare = f(hare);
+
+    size_t mu = 0;
+    while (!(tortoise == hare))
+    {
+        tortoise = f(tortoise);
+        hare = f(hare);
+        ++mu;
+    }
+
+    return std::make_pair(mu, lambda);
+}
+
+// Online cycle detector for simulations: states are added one step at a time (steps
+// are numbered from 0) together with the counter to extrapolate (height, score, ...).
+// TState needs operator <. No static state: every instance is independent.
+template <typename TState, typename TValue = long long>
+class CycleDetector
+{
+public:
+    static constexpr auto npos{ static_cast<size_t>(-1) };
+
+public:
+    CycleDetector()
+        : _mu(npos)
+        , _lambda(0)
+    {
+    }
+
+    void Clear()
+    {
+        _seen.clear();
+        _values.clear();
+        _mu = npos;
+        _lambda = 0;
+    }
+
+    // Returns true when 'state' closes a cycle (and from then on)
+    bool Add(const TState& state, TValue value)
+    {
+        if (Found())
+            return true;
+
+        const size_t step = _values.size();
+        _values.push_back(value);
+
+        auto [it, inserted] = _seen.insert(std::make_pair(state, step));
+        if (inserted)
+            return false;
+
+        // bingo!
+        _mu = it->second;
+        _lambda = step - it->second;
+        return true;
+    }
+
+    bool Found() const { return _mu != npos; }
+
+    size_t Mu() const { return _mu; }
+    size_t Lambda() const { return _lambda; }
+    size_t Steps() const { return _values.size(); }
+
+    const TValue& Value(size_t step) const { return _values[step]; }
+
+    // Maps any step (also far beyond the recorded ones) to the recorded step at the same
+    // position into the cycle; 'full_cycles' receives the number of skipped cycles.
+    // Throws std::logic_error for a step not recorded yet, while no cycle is found
+    size_t CycleStep(size_t step, size_t& full_cycles) const
+    {
+        full_cycles = 0;
+        if (step < _values.size())
+            return step;
+        if (!Found())
+            throw std::logic_error("CycleDetector: step beyond the recorded ones, and no cycle found");
+
+        full_cycles = (step - _mu) / _lambda;
+        return _mu + (step - _mu) % _lambda;
+    }
+
+    // Counter value at any step (needs TValue + - and * by an integer)
+    TValue Extrapolate(size_t step) const
+    {
+        size_t full_cycles;
+        const size_t cycle_step = CycleStep(step, full_cycles);
+        if (full_cycles == 0)
+            return _values[cycle_step];
+
+        const TValue delta = _values[_mu + _lambda] - _values[_mu];
+        return _values[cycle_step] + static_cast<TValue>(full_cycles) * delta;
+    }
+
+private:
+    std::map<TState, size_t>  _seen;
+    std::vector<TValue>       _values;
+    size_t                    _mu;
+    size_t                    _lambda;
+};
@@ -0,0 +1,112 @@
+// (c) 2023 Federico Molara <federico@molara.net>
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// The whole of 'in', in memory
+inline std::string ReadAll(std::istream& in)
+{
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Calls on_line(std::string_view) for every line of 'in' (without "\n" or "\r\n"), reading
+// the input in chunks: memory is O(chunk + longest line), whatever the length of the input.
+// The views are valid only during the call. Returns the number of bytes read.
+template <typename TOnLine>
+size_t ForEachLine(std::istream& in, TOnLine on_line, size_t chunk_size = 1 << 16)
+{
+    auto trim = [](const char* begin, const char* end) {
+        if (end != begin && end[-1] == '\r')
+            --end;
+        return std::string_view(begin, end - begin);
+    };
+
+    std::vector<char> buffer(chunk_size);
+    size_t kept = 0;  // beginning of a line, from the previous chunk
+    size_t bytes = 0;
+    while (in)
+    {
+        if (kept == buffer.size())  // line longer than a chunk
+            buffer.resize(2 * buffer.size());
+
+        in.read(buffer.data() + kept, buffer.size() - kept);
+        const size_t read = (size_t)in.gcount();
+        if (read == 0)
+            break;
+        bytes += read;
+
+        const char* begin = buffer.data();
+        const char* end = buffer.data() + kept + read;
+        for (const char* ch = begin; ch != end; ++ch)  // lines are short: faster than memchr()
+        {
+            if (*ch == '\n')
+            {
+                on_line(trim(begin, ch));
+                begin = ch + 1;
+            }
+        }
+
+        kept = end - begin;
+        std::memmove(buffer.data(), begin, kept);
+    }
+
+    if (kept > 0)  // last line, without "\n"
+        on_line(trim(buffer.data(), buffer.data() + kept));
+
+    return bytes;
+}
+
+// Calls on_line(std::string_view) for every line of an in-memory (or mapped) text
+// (constexpr: solvers built on it can be checked at compile time)
+template <typename TOnLine>
+constexpr void ForEachLine(std::string_view data, TOnLine on_line)
+{
+    const char* begin = data.data();
+    const char* end = data.data() + data.size();
+    for (const char* ch = begin; ch != end; ++ch)
+    {
+        if (*ch == '\n')
+        {
+            on_line(std::string_view(begin, ch - begin - (ch != begin && ch[-1] == '\r')));
+            begin = ch + 1;
+        }
+    }
+
+    if (begin != end)  // last line, without "\n"
+        on_line(std::string_view(begin, end - begin - (end[-1] == '\r')));
+}
+
+// Leading integer of 'str', skipping it (and the delimiter that follows, if any)
+constexpr int ParseInt(std::string_view& str)
+{
+    size_t i = 0;
+    const bool negative = !str.empty() && str[0] == '-';
+    if (negative)
+        ++i;
+
+    int value = 0;
+    for (; i < str.size() && '0' <= str[i] && str[i] <= '9'; ++i)
+        value = value * 10 + (str[i] - '0');
+
+    str.remove_prefix(std::min(i + 1, str.size()));
+    return negative ? -value : value;
+}
+
+// n-th line (0 based) of an in-memory text, empty if missing
+constexpr std::string_view NthLine(std::string_view data, size_t n)
+{
+    std::string_view nth;
+    ForEachLine(data, [&](std::string_view line) {
+        if (n-- == 0)
+            nth = line;
+    });
+    return nth;
+}
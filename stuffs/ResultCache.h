@@ -0,0 +1,125 @@
+// (c) 2023 Federico Molara <federico@molara.net>
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include "LineReader.h"
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// FNV-1a, 64 bit
+inline unsigned long long Fnv1a(std::string_view data)
+{
+    unsigned long long hash = 0xcbf29ce484222325ULL;
+    for (const unsigned char ch : data)
+    {
+        hash ^= ch;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+inline std::string ToHex(unsigned long long value)
+{
+    std::ostringstream os;
+    os << std::hex << std::setw(16) << std::setfill('0') << value;
+    return os.str();
+}
+
+// On-disk cache of answers (and of expensive intermediate structures), content-addressed:
+// every entry is a file named after the hash of its key, the key being day, part,
+// parameters and hash of the input. Any I/O failure is just a cache miss.
+class ResultCache
+{
+public:
+    explicit ResultCache(const std::string& directory = "cache")
+        : _directory(directory)
+    {
+    }
+
+    static std::string Key(const std::string& day, const std::string& part, const std::string& params, std::string_view input)
+    {
+        return day + '/' + part + '/' + params + '/' + ToHex(Fnv1a(input));
+    }
+
+    bool Load(const std::string& key, std::string& value) const
+    {
+        std::ifstream file(PathOf(key), std::ios::binary);
+        if (!file)
+            return false;
+
+        std::string stored_key;
+        if (!std::getline(file, stored_key) || stored_key != key)  // hash collision (or garbage)
+            return false;
+
+        value = ReadAll(file);
+        return true;
+    }
+
+    bool Store(const std::string& key, const std::string& value) const
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(_directory, ec);
+
+        // write aside and rename: concurrent readers never see half entries
+        const std::filesystem::path path = PathOf(key);
+        std::ostringstream tmp_name;
+        tmp_name << path.filename().string() << ".tmp" << std::this_thread::get_id();
+        const std::filesystem::path tmp = path.parent_path() / tmp_name.str();
+        {
+            std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+            if (!file)
+                return false;
+            file << key << '\n' << value;
+            file.close();
+            if (!file)
+            {
+                std::filesystem::remove(tmp, ec);
+                return false;
+            }
+        }
+
+        std::filesystem::rename(tmp, path, ec);
+        if (ec)
+        {
+            std::filesystem::remove(tmp, ec);  // no leftovers: the entry is just not stored
+            return false;
+        }
+        return true;
+    }
+
+    // Cached answer, or solve() and store its answer (T needs operator << and >>)
+    template <typename T, typename TSolve>
+    T Get(const std::string& key, TSolve solve) const
+    {
+        std::string text;
+        if (Load(key, text))
+        {
+            std::istringstream is(text);
+            T value;
+            if (is >> value)
+                return value;
+        }
+
+        const T value = solve();
+
+        std::ostringstream os;
+        os << value;
+        Store(key, os.str());
+
+        return value;
+    }
+
+private:
+    std::filesystem::path PathOf(const std::string& key) const
+    {
+        return std::filesystem::path(_directory) / (ToHex(Fnv1a(key)) + ".txt");
+    }
+
+    const std::string _directory;
+};
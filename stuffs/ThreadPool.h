@@ -0,0 +1,262 @@
+// (c) 2023 Federico Molara <federico@molara.net>
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <utility>
+
+// Work-stealing thread pool.
+// Every participant owns a queue: it runs its newest task first and, when idle, steals
+// the oldest task of the others. A pool of N threads starts N-1 workers: the thread
+// that waits for the results (TaskGroup::Wait) is the N-th one.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(size_t num_threads = 0)
+        : _queues(num_threads > 0 ? num_threads : std::max<size_t>(1, std::thread::hardware_concurrency()))
+        , _queued(0)
+        , _stop(false)
+    {
+        for (size_t i = 1; i < _queues.size(); ++i)
+            _workers.emplace_back(&ThreadPool::Worker, this, i);
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_sleep_mutex);
+            _stop = true;
+        }
+        _wakeup.notify_all();
+        for (auto& w : _workers)
+            w.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator = (const ThreadPool&) = delete;
+
+    size_t Size() const { return _queues.size(); }
+
+    void Submit(std::function<void()> task)
+    {
+        {
+            WorkQueue& queue = _queues[Self()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        ++_queued;
+
+        { std::lock_guard<std::mutex> lock(_sleep_mutex); }  // no lost wake-ups
+        _wakeup.notify_one();
+    }
+
+    // Runs one pending task, if any (used by threads waiting for their tasks)
+    bool RunPending()
+    {
+        std::function<void()> task;
+        if (!Pop(Self(), task))
+            return false;
+
+        task();
+        return true;
+    }
+
+private:
+    struct WorkQueue
+    {
+        std::mutex                         mutex;
+        std::deque<std::function<void()>>  tasks;
+    };
+
+    // Queue owned by the calling thread: workers have their own, any other thread uses #0
+    size_t Self() const
+    {
+        const auto& current = Current();
+        return current.first == this ? current.second : 0;
+    }
+
+    static std::pair<const ThreadPool*, size_t>& Current()
+    {
+        static thread_local std::pair<const ThreadPool*, size_t> current(nullptr, 0);
+        return current;
+    }
+
+    bool Pop(size_t self, std::function<void()>& task)
+    {
+        for (size_t i = 0; i < _queues.size(); ++i)
+        {
+            WorkQueue& queue = _queues[(self + i) % _queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty())
+                continue;
+
+            if (i == 0)  // own queue: newest first
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            else  // steal: oldest first
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            --_queued;
+            return true;
+        }
+
+        return false;
+    }
+
+    void Worker(size_t self)
+    {
+        Current() = std::make_pair(this, self);
+
+        while (true)
+        {
+            if (RunPending())
+                continue;
+
+            std::unique_lock<std::mutex> lock(_sleep_mutex);
+            _wakeup.wait(lock, [this]() { return _stop || _queued > 0; });
+            if (_stop)
+                break;
+        }
+    }
+
+private:
+    std::vector<WorkQueue>    _queues;
+    std::vector<std::thread>  _workers;
+    std::atomic<size_t>       _queued;
+    std::mutex                _sleep_mutex;
+    std::condition_variable   _wakeup;
+    bool                      _stop;
+};
+
+// Set of tasks to wait for. Tasks may run other tasks in the same group.
+// An exception thrown by a task does not stop the others: the first one is rethrown by Wait()
+class TaskGroup
+{
+public:
+    explicit TaskGroup(ThreadPool& pool)
+        : _pool(pool)
+        , _pending(0)
+    {
+    }
+
+    ~TaskGroup()
+    {
+        Drain();  // never throws: exceptions are only reported by Wait()
+    }
+
+    template <typename TFunc>
+    void Run(TFunc func)
+    {
+        ++_pending;
+        _pool.Submit([this, func]() mutable {
+            try
+            {
+                func();
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(_error_mutex);
+                if (!_error)
+                    _error = std::current_exception();
+            }
+            --_pending;
+        });
+    }
+
+    // Helps running tasks until all the tasks of the group are done, then rethrows the
+    // first exception thrown by a task, if any
+    void Wait()
+    {
+        Drain();
+
+        std::exception_ptr error;
+        {
+            std::lock_guard<std::mutex> lock(_error_mutex);
+            std::swap(error, _error);
+        }
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+private:
+    void Drain()
+    {
+        while (_pending > 0)
+            if (!_pool.RunPending())
+                std::this_thread::yield();
+    }
+
+private:
+    ThreadPool&          _pool;
+    std::atomic<size_t>  _pending;
+    std::mutex           _error_mutex;
+    std::exception_ptr   _error;
+};
+
+// Calls body(i) for each i in [begin ; end), a chunk of at least 'grain' indexes per task
+template <typename TBody>
+void ParallelFor(ThreadPool& pool, size_t begin, size_t end, TBody body, size_t grain = 1)
+{
+    if (begin >= end)
+        return;
+
+    const size_t chunk = std::max(grain, (end - begin + 4 * pool.Size() - 1) / (4 * pool.Size()));
+
+    // submitted backwards: the owner runs the first chunk first, thieves steal from the last one
+    TaskGroup group(pool);
+    for (size_t from = begin + (end - begin - 1) / chunk * chunk; ; from -= chunk)
+    {
+        const size_t to = std::min(end, from + chunk);
+        group.Run([from, to, &body]() {
+            for (size_t i = from; i < to; ++i)
+                body(i);
+        });
+
+        if (from == begin)
+            break;
+    }
+    group.Wait();
+}
+
+// Returns reduce(...reduce(reduce(identity, map(begin)), map(begin+1))..., map(end-1));
+// 'reduce' must be associative: partial results of the chunks are merged in order
+template <typename T, typename TMap, typename TReduce>
+T ParallelReduce(ThreadPool& pool, size_t begin, size_t end, T identity, TMap map, TReduce reduce, size_t grain = 1)
+{
+    if (begin >= end)
+        return identity;
+
+    const size_t chunk = std::max(grain, (end - begin + 4 * pool.Size() - 1) / (4 * pool.Size()));
+    std::vector<T> partials((end - begin + chunk - 1) / chunk, identity);
+
+    TaskGroup group(pool);
+    for (size_t from = begin, k = 0; from < end; from += chunk, ++k)
+    {
+        const size_t to = std::min(end, from + chunk);
+        group.Run([from, to, k, &partials, &map, &reduce]() {
+            T partial = partials[k];
+            for (size_t i = from; i < to; ++i)
+                partial = reduce(partial, map(i));
+            partials[k] = partial;
+        });
+    }
+    group.Wait();
+
+    T result = identity;
+    for (const auto& partial : partials)
+        result = reduce(result, partial);
+    return result;
+}
@@ -0,0 +1,140 @@
+// (c) 2023 Federico Molara <federico@molara.net>
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Recorder of the phases of the solvers (parse, graph build, search...), per thread,
+// exported as Chrome trace-event JSON: load it in chrome://tracing or ui.perfetto.dev.
+// Phases are recorded only when compiled with AOC_TRACE: otherwise TRACE_SCOPE and
+// TRACE_SAVE expand to nothing.
+// The solvers share the names of the phases, so that traces of different days compare:
+// "part one" and "part two" (or "both parts", when a single pass answers both) around
+// "parse", "graph build", "search", "answer" (the category is the day). A day records
+// only the phases it has: no "parse" when the input is consumed while solving, no
+// "graph build" without a graph, no "answer" when the answer is just the result of the
+// search.
+class Tracer
+{
+public:
+    typedef std::chrono::steady_clock clock;
+
+    static Tracer& Instance()
+    {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    void Record(std::string name, const char* category, clock::time_point begin, clock::time_point end)
+    {
+        const long long ts  = std::chrono::duration_cast<std::chrono::microseconds>(begin - _origin).count();
+        const long long dur = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _events.push_back({ std::move(name), category, ts, dur, ThreadId() });
+    }
+
+    // Complete events ("ph": "X"), one track per thread
+    bool Save(const std::string& path) const
+    {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file)
+            return false;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        for (size_t i = 0; i < _events.size(); ++i)
+        {
+            const Event& e = _events[i];
+            file << (i == 0 ? "\n" : ",\n")
+                 << "{\"name\":\"" << Escape(e.name) << "\",\"cat\":\"" << Escape(e.category) << "\",\"ph\":\"X\""
+                 << ",\"ts\":" << e.ts << ",\"dur\":" << e.dur << ",\"pid\":1,\"tid\":" << e.tid << "}";
+        }
+        file << "\n]}\n";
+        return (bool)file;
+    }
+
+private:
+    struct Event
+    {
+        std::string  name;
+        const char*  category;
+        long long    ts;   // us since the first use of the tracer
+        long long    dur;  // us
+        unsigned     tid;
+    };
+
+    Tracer()
+        : _origin(clock::now())
+        , _next_tid(0)
+    {
+    }
+
+    // Small sequential ids, in order of first event: easier to read than native ids
+    unsigned ThreadId()
+    {
+        static thread_local unsigned tid = _next_tid++;
+        return tid;
+    }
+
+    static std::string Escape(const std::string& str)
+    {
+        std::string escaped;
+        for (const char ch : str)
+        {
+            if (ch == '"' || ch == '\\')
+                escaped += '\\';
+            if ((unsigned char)ch >= 0x20)
+                escaped += ch;
+        }
+        return escaped;
+    }
+
+    const clock::time_point  _origin;
+    std::atomic<unsigned>    _next_tid;
+    mutable std::mutex       _mutex;
+    std::vector<Event>       _events;
+};
+
+// Records the lifetime of the scope as a phase
+class TraceScope
+{
+public:
+    explicit TraceScope(std::string name, const char* category = "phase")
+        : _tracer(Tracer::Instance())  // first: the origin of the times precedes _begin
+        , _name(std::move(name))
+        , _category(category)
+        , _begin(Tracer::clock::now())
+    {
+    }
+
+    ~TraceScope()
+    {
+        _tracer.Record(std::move(_name), _category, _begin, Tracer::clock::now());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator = (const TraceScope&) = delete;
+
+private:
+    Tracer&                    _tracer;
+    std::string                _name;
+    const char*                _category;
+    Tracer::clock::time_point  _begin;
+};
+
+#ifdef AOC_TRACE
+    #define TRACE_CONCAT_(a, b)           a##b
+    #define TRACE_CONCAT(a, b)            TRACE_CONCAT_(a, b)
+    #define TRACE_SCOPE(name, category)   TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(name, category)
+    #define TRACE_SAVE(path)              Tracer::Instance().Save(path)
+#else
+    #define TRACE_SCOPE(name, category)   ((void)0)
+    #define TRACE_SAVE(path)              ((void)0)
+#endif